@@ -0,0 +1,440 @@
+/*
+ * Benchmark suite: throughput of the chunking paths over fixed,
+ * reproducible data, as JSON that test/bench_compare.py can diff
+ * against a saved baseline.
+ *
+ *	bench [-c cpu] [-r reps] [-s MiB] [-f filter] [pmlog.dat]
+ *
+ * Every case is run once to warm up (page faults, table setup, branch
+ * predictors) and then -r times (default 9) timed; the JSON has the
+ * min, median, 90th percentile and max over those runs, in ns/byte
+ * and MB/s (MB as in examples/engines: 2^20 bytes).  The process is
+ * pinned to one CPU (-c, default whichever it started on; -1 to not
+ * pin) so runs aren't spread over cores with different clocks.
+ *
+ * The datasets are -s MiB (default 32) each of seeded random bytes,
+ * zeros, generated English-like text and, if a path is given, that
+ * file repeated to the same size (named after the file: pmlog for
+ * test/data/pmlog.dat).  Cases are
+ *
+ *	block_next/<engine>/w<window>/<config>[/<digest>]/<data>
+ *		rp_block_next() over an rp_from_view() of the data
+ *	calc_rabin/w<window>/<data>
+ *		calc_rabin() a byte at a time, the way it used to be done
+ *	simhash/<data>
+ *		what simhash.c does per chunk: rp_fingerprints() with a
+ *		512 byte window in 64K batches, keeping the top 4 sums
+ *
+ * and -f runs only those whose name contains the filter.  Each result
+ * carries a check value (blocks or a sum of fingerprints) that must
+ * be the same between runs being compared, or they didn't do the same
+ * work.
+ */
+
+#define _GNU_SOURCE
+
+#include <assert.h>
+#include <errno.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <rabinpoly.h>
+
+#define POLYNOM 0xbfe6b8a5bf378d83LL
+#define SIMHASH_POLYNOM 0x3f63dfbf84af3bLL
+#define SIMHASH_CHUNK (8 << 20)
+#define SIMHASH_BATCH (64 * 1024)
+#define SIMHASH_K 4
+
+struct dataset {
+	char *name;
+	unsigned char *data;
+	size_t size;
+};
+
+enum kind { BLOCK_NEXT, CALC_RABIN, SIMHASH };
+
+struct config {
+	const char *name;
+	size_t min, avg, max;
+} configs[] = {
+	{ "8k", 2048, 8192, 65536 },
+	{ "64k", 16384, 65536, 262144 },
+};
+
+struct bench_case {
+	enum kind kind;
+	enum rp_engine engine;
+	unsigned int window_size;
+	const struct config *config;
+	enum rp_digest digest;
+} cases[] = {
+	{ BLOCK_NEXT, RP_ENGINE_RABIN, 32, &configs[0], RP_DIGEST_NONE },
+	{ BLOCK_NEXT, RP_ENGINE_RABIN, 64, &configs[0], RP_DIGEST_NONE },
+	{ BLOCK_NEXT, RP_ENGINE_RABIN, 128, &configs[0], RP_DIGEST_NONE },
+	{ BLOCK_NEXT, RP_ENGINE_RABIN, 32, &configs[1], RP_DIGEST_NONE },
+	{ BLOCK_NEXT, RP_ENGINE_GEAR, 32, &configs[0], RP_DIGEST_NONE },
+	{ BLOCK_NEXT, RP_ENGINE_RABIN, 32, &configs[0], RP_DIGEST_XXH3_128 },
+	{ BLOCK_NEXT, RP_ENGINE_RABIN, 32, &configs[0], RP_DIGEST_BLAKE3 },
+	{ CALC_RABIN, RP_ENGINE_RABIN, 32, &configs[0], RP_DIGEST_NONE },
+	{ CALC_RABIN, RP_ENGINE_RABIN, 128, &configs[0], RP_DIGEST_NONE },
+	{ SIMHASH, RP_ENGINE_RABIN, 512, NULL, RP_DIGEST_NONE },
+};
+
+static const char *digest_names[] = { "", "xxh3", "blake3" };
+
+static const char *words[] = {
+	"the", "of", "and", "to", "a", "in", "is", "it", "that", "was",
+	"for", "on", "are", "with", "as", "be", "at", "this", "have", "from",
+	"or", "by", "one", "had", "not", "but", "what", "all", "were", "when",
+	"we", "there", "can", "an", "your", "which", "their", "said", "if",
+	"do", "will", "each", "about", "how", "up", "out", "them", "then",
+	"she", "many", "some", "so", "these", "would", "other", "into",
+	"has", "more", "her", "two", "like", "him", "see", "time", "could",
+	"block", "file", "data", "polynomial", "fingerprint", "window",
+	"boundary", "storage", "duplicate", "buffer", "stream", "offset",
+};
+
+static u_int64_t xorshift(u_int64_t *s)
+{
+	*s ^= *s >> 12;
+	*s ^= *s << 25;
+	*s ^= *s >> 27;
+	return *s * 0x2545f4914f6cdd1dULL;
+}
+
+static void fill_random(unsigned char *p, size_t size)
+{
+	u_int64_t s = 42, r;
+	size_t i;
+
+	for (i = 0; i + 8 <= size; i += 8) {
+		r = xorshift(&s);
+		memcpy(p + i, &r, 8);
+	}
+	for (r = xorshift(&s); i < size; i++, r >>= 8)
+		p[i] = r;
+}
+
+/*
+ * Words with a skewed frequency (the smaller of two uniform picks),
+ * sentences of about a dozen of them, paragraphs of about eight
+ * sentences: enough repetition and structure for the rolling hash to
+ * see something other than noise.
+ */
+static void fill_text(unsigned char *p, size_t size)
+{
+	size_t nwords = sizeof(words) / sizeof(words[0]);
+	u_int64_t s = 42;
+	size_t i = 0;
+
+	while (i < size) {
+		u_int64_t r = xorshift(&s);
+		size_t a = r % nwords, b = (r >> 16) % nwords;
+		const char *w = words[a < b ? a : b];
+		size_t n = strlen(w);
+
+		if (n > size - i)
+			n = size - i;
+		memcpy(p + i, w, n);
+		i += n;
+		if (i < size)
+			p[i++] = (r >> 32) % 12 ? ' ' :
+				 (r >> 40) % 8 ? '.' : '\n';
+	}
+}
+
+static int fill_file(unsigned char *p, size_t size, const char *path)
+{
+	FILE *f = fopen(path, "rb");
+	size_t n = 0, i;
+
+	if (!f)
+		return errno;
+	n = fread(p, 1, size, f);
+	fclose(f);
+	if (!n)
+		return EINVAL;
+	for (i = n; i < size; i++)
+		p[i] = p[i - n];
+	return 0;
+}
+
+/* test/data/pmlog.dat is called "pmlog" in case names */
+static char *file_name(const char *path)
+{
+	const char *base = strrchr(path, '/');
+	char *name = strdup(base ? base + 1 : path), *dot;
+
+	assert(name);
+	dot = strchr(name, '.');
+	if (dot && dot != name)
+		*dot = '\0';
+	return name;
+}
+
+static u_int64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (u_int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void case_name(const struct bench_case *c, const struct dataset *d,
+		      char *buf, size_t size)
+{
+	switch (c->kind) {
+	case BLOCK_NEXT:
+		snprintf(buf, size, "block_next/%s/w%u/%s%s%s/%s",
+			 c->engine == RP_ENGINE_GEAR ? "gear" : "rabin",
+			 c->window_size, c->config->name,
+			 c->digest ? "/" : "", digest_names[c->digest],
+			 d->name);
+		break;
+	case CALC_RABIN:
+		snprintf(buf, size, "calc_rabin/w%u/%s", c->window_size,
+			 d->name);
+		break;
+	case SIMHASH:
+		snprintf(buf, size, "simhash/%s", d->name);
+		break;
+	}
+}
+
+static u_int64_t run_block_next(RabinPoly *rp, const struct dataset *d)
+{
+	u_int64_t blocks = 0;
+
+	rp_from_view(rp, d->data, d->size);
+	while (!rp_block_next(rp))
+		blocks++;
+	assert(rp->error == EOF);
+	return blocks;
+}
+
+static u_int64_t run_calc_rabin(RabinPoly *rp, const struct dataset *d)
+{
+	u_int64_t sum = 0;
+
+	rp_from_view(rp, d->data, d->size);
+	while (!calc_rabin(rp))
+		sum += rp->fingerprint;
+	assert(rp->error == EOF);
+	return sum;
+}
+
+static u_int64_t run_simhash(RabinPoly *rp, const struct dataset *d,
+			     u_int64_t *fps)
+{
+	u_int64_t sum = 0;
+	size_t chunk, off, stop, i, j;
+
+	for (chunk = 0; chunk < d->size; chunk += SIMHASH_CHUNK) {
+		size_t end = d->size - chunk < SIMHASH_CHUNK ?
+			     d->size - chunk : SIMHASH_CHUNK;
+		u_int64_t top[SIMHASH_K] = { 0 };
+
+		for (off = rp->window_size; off < end; off += SIMHASH_BATCH) {
+			stop = off + SIMHASH_BATCH < end ?
+			       off + SIMHASH_BATCH : end;
+			rp_fingerprints(rp, d->data + chunk, off, stop, fps);
+			/* top[0] is the smallest kept */
+			for (i = 0; i < stop - off; i++) {
+				if (fps[i] <= top[0])
+					continue;
+				for (j = 1; j < SIMHASH_K &&
+					    fps[i] > top[j]; j++)
+					top[j - 1] = top[j];
+				top[j - 1] = fps[i];
+			}
+		}
+		for (i = 0; i < SIMHASH_K; i++)
+			sum += top[i];
+	}
+	return sum;
+}
+
+static int cmp_ns(const void *a, const void *b)
+{
+	u_int64_t x = *(const u_int64_t *)a, y = *(const u_int64_t *)b;
+
+	return x < y ? -1 : x > y;
+}
+
+/* nearest rank */
+static u_int64_t percentile(const u_int64_t *sorted, int n, int p)
+{
+	int rank = (p * n + 99) / 100;
+
+	return sorted[rank ? rank - 1 : 0];
+}
+
+static void print_stat(const char *name, const u_int64_t *sorted, int n,
+		       int p, size_t bytes, int last)
+{
+	u_int64_t ns = percentile(sorted, n, p);
+
+	printf("\t\t\t\"%s\": {\"ns_per_byte\": %.4f, \"mb_per_s\": %.1f}%s\n",
+	       name, (double)ns / bytes,
+	       ns ? bytes / (ns / 1e9) / (1 << 20) : 0.0, last ? "" : ",");
+}
+
+static void run_case(const struct bench_case *c, const struct dataset *d,
+		     int reps, u_int64_t *ns, u_int64_t *fps, int first)
+{
+	char name[128];
+	u_int64_t check = 0, begin;
+	RabinPoly *rp;
+	int r;
+
+	case_name(c, d, name, sizeof(name));
+	fprintf(stderr, "%s\n", name);
+
+	if (c->kind == SIMHASH)
+		rp = rp_new(c->window_size, 8192, 2048, 65536, 0,
+			    SIMHASH_POLYNOM);
+	else
+		rp = rp_new_engine(c->engine, c->window_size, c->config->avg,
+				   c->config->min, c->config->max,
+				   c->config->max * 2, POLYNOM);
+	assert(rp);
+	if (c->digest)
+		rp_set_digest(rp, c->digest);
+
+	/* run 0 is the warmup */
+	for (r = 0; r <= reps; r++) {
+		begin = now_ns();
+		switch (c->kind) {
+		case BLOCK_NEXT:
+			check = run_block_next(rp, d);
+			break;
+		case CALC_RABIN:
+			check = run_calc_rabin(rp, d);
+			break;
+		case SIMHASH:
+			check = run_simhash(rp, d, fps);
+			break;
+		}
+		if (r)
+			ns[r - 1] = now_ns() - begin;
+	}
+	rp_free(rp);
+
+	qsort(ns, reps, sizeof(*ns), cmp_ns);
+	printf("%s\t\t\"%s\": {\n", first ? "" : ",\n", name);
+	printf("\t\t\t\"bytes\": %zu,\n", d->size);
+	printf("\t\t\t\"check\": \"%016llx\",\n", (unsigned long long)check);
+	print_stat("min", ns, reps, 0, d->size, 0);
+	print_stat("p50", ns, reps, 50, d->size, 0);
+	print_stat("p90", ns, reps, 90, d->size, 0);
+	print_stat("max", ns, reps, 100, d->size, 1);
+	printf("\t\t}");
+	fflush(stdout);
+}
+
+int main(int argc, char **argv)
+{
+	struct dataset datasets[4];
+	const char *filter = NULL, *simd = getenv("RABINPOLY_SIMD");
+	int cpu = sched_getcpu(), reps = 9, ndatasets = 0, first = 1;
+	size_t size = 32, i, c;
+	u_int64_t *ns, *fps;
+	int opt, rc;
+
+	while ((opt = getopt(argc, argv, "c:r:s:f:")) != -1) {
+		switch (opt) {
+		case 'c':
+			cpu = atoi(optarg);
+			break;
+		case 'r':
+			reps = atoi(optarg);
+			break;
+		case 's':
+			size = atol(optarg);
+			break;
+		case 'f':
+			filter = optarg;
+			break;
+		default:
+			goto usage;
+		}
+	}
+	if (argc - optind > 1 || reps < 1 || !size) {
+usage:
+		fprintf(stderr, "usage: %s [-c cpu] [-r reps] [-s MiB] "
+			"[-f filter] [file]\n", argv[0]);
+		return 1;
+	}
+	size <<= 20;
+
+	if (cpu >= 0) {
+		cpu_set_t set;
+
+		CPU_ZERO(&set);
+		CPU_SET(cpu, &set);
+		if (sched_setaffinity(0, sizeof(set), &set)) {
+			fprintf(stderr, "%s: cpu %d: %s\n", argv[0], cpu,
+				strerror(errno));
+			return 1;
+		}
+	}
+
+	datasets[ndatasets].name = "random";
+	datasets[ndatasets++].data = malloc(size);
+	datasets[ndatasets].name = "zeros";
+	datasets[ndatasets++].data = calloc(1, size);
+	datasets[ndatasets].name = "text";
+	datasets[ndatasets++].data = malloc(size);
+	if (optind < argc) {
+		datasets[ndatasets].name = file_name(argv[optind]);
+		datasets[ndatasets++].data = malloc(size);
+	}
+	for (i = 0; i < (size_t)ndatasets; i++) {
+		assert(datasets[i].data);
+		datasets[i].size = size;
+	}
+	fill_random(datasets[0].data, size);
+	fill_text(datasets[2].data, size);
+	if (optind < argc) {
+		rc = fill_file(datasets[3].data, size, argv[optind]);
+		if (rc) {
+			fprintf(stderr, "%s: %s\n", argv[optind], strerror(rc));
+			return 1;
+		}
+	}
+
+	ns = malloc(reps * sizeof(*ns));
+	fps = malloc(SIMHASH_BATCH * sizeof(*fps));
+	assert(ns && fps);
+
+	printf("{\n");
+	printf("\t\"cpu\": %d,\n", cpu);
+	printf("\t\"reps\": %d,\n", reps);
+	printf("\t\"simd\": \"%s\",\n", simd ? simd : "auto");
+	printf("\t\"file\": \"%s\",\n", optind < argc ? argv[optind] : "");
+	printf("\t\"results\": {\n");
+	for (c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+		for (i = 0; i < (size_t)ndatasets; i++) {
+			char name[128];
+
+			case_name(&cases[c], &datasets[i], name, sizeof(name));
+			if (filter && !strstr(name, filter))
+				continue;
+			run_case(&cases[c], &datasets[i], reps, ns, fps, first);
+			first = 0;
+		}
+	}
+	printf("\n\t}\n}\n");
+
+	for (i = 0; i < (size_t)ndatasets; i++)
+		free(datasets[i].data);
+	if (optind < argc)
+		free(datasets[3].name);
+	free(ns);
+	free(fps);
+	return 0;
+}
@@ -0,0 +1,147 @@
+/*
+ * How much would block-level dedup save on a set of files?
+ *
+ *	dedup [-bgq] [-M MiB] [-w window] [-m min] [-a avg] [-x max] path...
+ *
+ * Directories are walked without crossing into other filesystems, the
+ * way hash_dir does with find -xdev, but instead of printing a line
+ * per block, blocks go into a fixed-size rp_dedup index and we print
+ * one line per file (unless -q) and a summary:
+ *
+ *	<bytes> <duplicate bytes> <path>
+ *
+ * -M sets the index size (default 1024 MiB, enough for 14 million
+ * blocks); if it fills up, the savings reported are a lower bound.
+ * -b keys blocks by BLAKE3 instead of xxh3-128, -g chunks with the
+ * gear engine.
+ */
+
+#define _XOPEN_SOURCE 500
+
+#include <assert.h>
+#include <errno.h>
+#include <ftw.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <rabinpoly.h>
+
+#define POLYNOM 0xbfe6b8a5bf378d83LL
+
+static RabinPoly *rp;
+static struct rp_dedup *seen;
+static u_int32_t nfiles;
+static int quiet, failed;
+
+static int visit(const char *path, const struct stat *st, int type,
+		 struct FTW *ftw)
+{
+	rp_dedup_stats stats;
+	int rc;
+
+	(void)ftw;
+	if (type != FTW_F || !S_ISREG(st->st_mode))
+		return 0;
+
+	rp_from_file(rp, path);
+	rc = rp_dedup_scan(seen, rp, nfiles++, &stats);
+	if (rc) {
+		fprintf(stderr, "%s: %s\n", path, strerror(rc));
+		failed = 1;
+	}
+	if (!quiet)
+		printf("%llu %llu %s\n", (unsigned long long)stats.bytes,
+		       (unsigned long long)(stats.bytes - stats.unique_bytes),
+		       path);
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	enum rp_engine engine = RP_ENGINE_RABIN;
+	enum rp_digest digest = RP_DIGEST_XXH3_128;
+	unsigned int window_size = 32;
+	size_t min_block_size = 2048;
+	size_t avg_block_size = 8192;
+	size_t max_block_size = 65536;
+	size_t memory = 1024;
+	rp_dedup_stats total;
+	int i, opt;
+
+	while ((opt = getopt(argc, argv, "bgqM:w:m:a:x:")) != -1) {
+		switch (opt) {
+		case 'b':
+			digest = RP_DIGEST_BLAKE3;
+			break;
+		case 'g':
+			engine = RP_ENGINE_GEAR;
+			break;
+		case 'q':
+			quiet = 1;
+			break;
+		case 'M':
+			memory = atol(optarg);
+			break;
+		case 'w':
+			window_size = atoi(optarg);
+			break;
+		case 'm':
+			min_block_size = atol(optarg);
+			break;
+		case 'a':
+			avg_block_size = atol(optarg);
+			break;
+		case 'x':
+			max_block_size = atol(optarg);
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-bgq] [-M MiB] [-w window] "
+				"[-m min] [-a avg] [-x max] path...\n", argv[0]);
+			return 1;
+		}
+	}
+	if (optind == argc) {
+		fprintf(stderr, "%s: no input files\n", argv[0]);
+		return 1;
+	}
+
+	rp = rp_new_engine(engine, window_size, avg_block_size,
+			   min_block_size, max_block_size, max_block_size * 2,
+			   POLYNOM);
+	assert(rp);
+	seen = rp_dedup_new(digest, memory << 20);
+	if (!seen) {
+		fprintf(stderr, "%s: index of %zu MiB: %s\n", argv[0], memory,
+			strerror(errno));
+		return 1;
+	}
+
+	for (i = optind; i < argc; i++) {
+		if (nftw(argv[i], visit, 64, FTW_PHYS | FTW_MOUNT)) {
+			perror(argv[i]);
+			failed = 1;
+		}
+	}
+
+	rp_dedup_totals(seen, &total);
+	printf("%u files, %llu bytes in %llu blocks, %llu bytes in %llu "
+	       "unique blocks\n", nfiles, (unsigned long long)total.bytes,
+	       (unsigned long long)total.blocks,
+	       (unsigned long long)total.unique_bytes,
+	       (unsigned long long)total.unique_blocks);
+	printf("dedup would save %llu bytes (%.1f%%)\n",
+	       (unsigned long long)(total.bytes - total.unique_bytes),
+	       total.bytes ? 100.0 * (total.bytes - total.unique_bytes) /
+			     total.bytes : 0.0);
+	if (total.untracked_blocks)
+		printf("index full: %llu unique blocks weren't remembered; "
+		       "the savings above are a lower bound (raise -M)\n",
+		       (unsigned long long)total.untracked_blocks);
+
+	rp_dedup_free(seen);
+	rp_free(rp);
+	return failed;
+}
@@ -0,0 +1,192 @@
+/*
+ * Compare the boundary engines: chunking throughput, block size
+ * distribution and how much a block-level dedup would save.
+ *
+ *	engines [-w window] [-m min] [-a avg] [-x max] file...
+ *
+ * Each file is chunked once per engine just to time the scan, then
+ * again to count unique blocks across all files.
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <rabinpoly.h>
+
+#define POLYNOM 0xbfe6b8a5bf378d83LL
+#define BATCH 1024
+
+struct engine {
+	const char *name;
+	enum rp_engine engine;
+} engines[] = {
+	{ "rabin", RP_ENGINE_RABIN },
+	{ "gear", RP_ENGINE_GEAR },
+};
+
+/* blocks are identified by length and a 64 bit FNV-1a content hash */
+struct seen {
+	u_int64_t hash;
+	size_t length;
+};
+
+static struct seen *table;
+static size_t table_size, table_used;
+
+static u_int64_t fnv1a(const unsigned char *p, size_t n)
+{
+	u_int64_t h = 0xcbf29ce484222325ULL;
+
+	while (n--) {
+		h ^= *p++;
+		h *= 0x100000001b3ULL;
+	}
+	return h;
+}
+
+static void table_grow(void);
+
+/* returns 1 if the block was new */
+static int table_insert(u_int64_t hash, size_t length)
+{
+	size_t i;
+
+	if (table_used * 2 >= table_size)
+		table_grow();
+
+	for (i = hash & (table_size - 1); table[i].length;
+	     i = (i + 1) & (table_size - 1)) {
+		if (table[i].hash == hash && table[i].length == length)
+			return 0;
+	}
+	table[i].hash = hash;
+	table[i].length = length;
+	table_used++;
+	return 1;
+}
+
+static void table_grow(void)
+{
+	struct seen *old = table;
+	size_t old_size = table_size, i;
+
+	table_size = table_size ? table_size * 2 : 1024;
+	table = calloc(table_size, sizeof(*table));
+	assert(table);
+	table_used = 0;
+	for (i = 0; i < old_size; i++)
+		if (old[i].length)
+			table_insert(old[i].hash, old[i].length);
+	free(old);
+}
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char **argv)
+{
+	unsigned int window_size = 32;
+	size_t min_block_size = 2048;
+	size_t avg_block_size = 8192;
+	size_t max_block_size = 65536;
+	rp_boundary *blocks;
+	unsigned int e;
+	int i, opt;
+
+	while ((opt = getopt(argc, argv, "w:m:a:x:")) != -1) {
+		switch (opt) {
+		case 'w':
+			window_size = atoi(optarg);
+			break;
+		case 'm':
+			min_block_size = atol(optarg);
+			break;
+		case 'a':
+			avg_block_size = atol(optarg);
+			break;
+		case 'x':
+			max_block_size = atol(optarg);
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-w window] [-m min] [-a avg] "
+				"[-x max] file...\n", argv[0]);
+			return 1;
+		}
+	}
+	if (optind == argc) {
+		fprintf(stderr, "%s: no input files\n", argv[0]);
+		return 1;
+	}
+
+	blocks = malloc(BATCH * sizeof(*blocks));
+	assert(blocks);
+
+	printf("%-6s %10s %10s %10s %10s %10s\n", "engine", "MB/s", "blocks",
+	       "avg", "stddev", "dedup");
+
+	for (e = 0; e < sizeof(engines) / sizeof(engines[0]); e++) {
+		double elapsed = 0, sum = 0, sumsq = 0, mean;
+		size_t total = 0, unique = 0, nblocks = 0;
+		RabinPoly *rp;
+
+		rp = rp_new_engine(engines[e].engine, window_size,
+				   avg_block_size, min_block_size,
+				   max_block_size, max_block_size * 2, POLYNOM);
+		assert(rp);
+
+		for (i = optind; i < argc; i++) {
+			double begin;
+			size_t n;
+
+			/* pass 1: chunking only */
+			rp_from_file(rp, argv[i]);
+			begin = now();
+			while ((n = rp_find_boundaries(rp, blocks, BATCH)) == BATCH)
+				;
+			elapsed += now() - begin;
+			if (rp->error != EOF) {
+				fprintf(stderr, "%s: %s\n", argv[i],
+					strerror(rp->error));
+				return 1;
+			}
+
+			/* pass 2: size distribution and dedup */
+			rp_from_file(rp, argv[i]);
+			while (!rp_block_next(rp)) {
+				double size = rp->block_size;
+
+				sum += size;
+				sumsq += size * size;
+				nblocks++;
+				total += rp->block_size;
+				if (table_insert(fnv1a(rp->block_addr, rp->block_size),
+						 rp->block_size))
+					unique += rp->block_size;
+			}
+		}
+
+		mean = nblocks ? sum / nblocks : 0;
+		printf("%-6s %10.1f %10zu %10.0f %10.0f %10.3f\n",
+		       engines[e].name, total / elapsed / 1024 / 1024, nblocks,
+		       mean, nblocks ? sqrt(sumsq / nblocks - mean * mean) : 0,
+		       unique ? (double)total / unique : 0);
+
+		rp_free(rp);
+		free(table);
+		table = NULL;
+		table_size = table_used = 0;
+	}
+
+	free(blocks);
+	return 0;
+}
@@ -0,0 +1,67 @@
+#include <assert.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <rabinpoly.h>
+
+#define POLYNOM 0xbfe6b8a5bf378d83LL
+
+/*
+ * Like hash_md5, but with the digests librabinpoly computes while
+ * chunking, so no OpenSSL is needed: xxh3-128 by default, BLAKE3 with
+ * -b.
+ */
+int main(int argc, char **argv) {
+	enum rp_engine engine = RP_ENGINE_RABIN;
+	enum rp_digest digest = RP_DIGEST_XXH3_128;
+	RabinPoly *rp;
+	size_t i, size;
+	int opt;
+
+	/* -g: find boundaries with the gear engine; -b: BLAKE3 digests */
+	while ((opt = getopt(argc, argv, "bg")) != -1) {
+		switch (opt) {
+		case 'b':
+			digest = RP_DIGEST_BLAKE3;
+			break;
+		case 'g':
+			engine = RP_ENGINE_GEAR;
+			break;
+		default:
+			goto usage;
+		}
+	}
+	if (argc - optind < 5) {
+usage:
+		fprintf(stderr, "usage: %s [-bg] window min avg max bufsize\n",
+			argv[0]);
+		return 1;
+	}
+
+	rp = rp_new_engine(engine, atoi(argv[optind]), atoi(argv[optind + 2]),
+			   atoi(argv[optind + 1]), atoi(argv[optind + 3]),
+			   atoi(argv[optind + 4]), POLYNOM);
+	assert(rp);
+	rp_set_digest(rp, digest);
+	size = rp_digest_size(digest);
+	rp_from_stream(rp, stdin);
+
+	for (;;) {
+		int rc = rp_block_next(rp);
+
+		if (rc) {
+			assert(rc == EOF);
+			break;
+		}
+		printf("%zu %zu ", rp->block_streampos, rp->block_size);
+		for (i = 0; i < size; i++) {
+			printf("%02x", rp->block_digest[i]);
+		}
+		printf("\n");
+	}
+
+	rp_free(rp);
+
+	return 0;
+}
@@ -2,17 +2,40 @@
 #include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <unistd.h>
 #include <rabinpoly.h>
 // #include <crypto.h>
+/* the MD5_* functions are deprecated as of OpenSSL 3.0 */
+#define OPENSSL_SUPPRESS_DEPRECATED
 #include <openssl/md5.h>
 
+#define POLYNOM 0xbfe6b8a5bf378d83LL
+
 // http://stackoverflow.com/questions/10324611/how-to-calculate-the-md5-hash-of-a-large-file-in-c
 // http://stackoverflow.com/questions/10129085/read-from-stdin-write-to-stdout-in-c
 
 int main(int argc, char **argv){
     MD5_CTX mdctx;
     unsigned char digest[MD5_DIGEST_LENGTH];
-    int i;
+    int i, opt;
+    enum rp_engine engine = RP_ENGINE_RABIN;
+
+	/* -g: find boundaries with the gear engine */
+	while ((opt = getopt(argc, argv, "g")) != -1) {
+		switch (opt) {
+		case 'g':
+			engine = RP_ENGINE_GEAR;
+			break;
+		default:
+			goto usage;
+		}
+	}
+	if (argc - optind < 5) {
+usage:
+		fprintf(stderr, "usage: %s [-g] window min avg max bufsize\n",
+			argv[0]);
+		return 1;
+	}
 
 	printf("argc %d\n", argc);
 	for (i=0; i < argc; i++) {
@@ -25,16 +48,17 @@ int main(int argc, char **argv){
 	// size_t max_block_size = 65536;
 	// size_t buf_size = max_block_size * 10;
 
-	unsigned int window_size = atoi(argv[1]);
-	size_t min_block_size = atoi(argv[2]);
-	size_t avg_block_size = atoi(argv[3]);
-	size_t max_block_size = atoi(argv[4]);
-	size_t buf_size = atoi(argv[5]);
+	unsigned int window_size = atoi(argv[optind]);
+	size_t min_block_size = atoi(argv[optind + 1]);
+	size_t avg_block_size = atoi(argv[optind + 2]);
+	size_t max_block_size = atoi(argv[optind + 3]);
+	size_t buf_size = atoi(argv[optind + 4]);
 
 	RabinPoly *rp;
    
-	rp = rp_new(window_size, 
-            avg_block_size, min_block_size, max_block_size, buf_size);
+	rp = rp_new_engine(engine, window_size,
+            avg_block_size, min_block_size, max_block_size, buf_size,
+            POLYNOM);
 	assert(rp);
 	rp_from_stream(rp, stdin);
 
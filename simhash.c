@@ -1,6 +1,10 @@
+#define _GNU_SOURCE
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <linux/limits.h>
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
 #include <dirent.h>
 #include <fcntl.h>
 #include <stdio.h>
@@ -10,7 +14,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <limits.h>
 #include <time.h>
+#include <pthread.h>
 #include "src/rabinpoly.h"
 
 
@@ -20,183 +26,1707 @@
 #define NUM_HASHES ((1<<23) - 512)
 #define M_OFFSET 8
 #define CHUNK_SIZE SZ_8M
+/* fingerprints computed per rp_fingerprints() call */
+#define FP_BATCH (64*1024)
 
 
-clock_t overall_begin, overall_end;
-clock_t read_elapsed, hash_elapsed;
+static enum rp_engine engine = RP_ENGINE_RABIN;
 
-static char path[PATH_MAX] = {0,};
-static char *pathp = path;
+/*
+ * Chunk sketches: the K largest fingerprints of a chunk (the K
+ * smallest with -b), each standing in for the fingerprint M_OFFSET
+ * bytes after it, which is what goes into the signature.
+ *
+ * The entries are kept in a min-heap, so the root is the one to beat,
+ * and a copy of its value ('threshold') turns almost every fingerprint
+ * away with a single compare; the heap is only touched when one gets
+ * in, which for K out of n random values happens O(K log n) times.
+ * Bottom-k is top-k on the complemented fingerprints.  An entry's
+ * offset fingerprint turns up M_OFFSET positions after the entry went
+ * in, and 'ring' remembers which entry went in at each of the last
+ * SKETCH_RING positions, so that's a lookup rather than a search.
+ */
+#define SKETCH_MIN 4
+#define SKETCH_MAX 256
+#define SKETCH_RING 16		/* a power of two above M_OFFSET */
 
-struct chunk_hash {
-	uint64_t unit_hashes[4];
-	loff_t  off;
-	int fd;
-	char filename[PATH_MAX];
-
-};
+static int sketch_k = 4;
+static int sketch_bottom;
 
-struct max_array {
-	// top 4 hashes
-	int i;
-	uint8_t size;
-	struct max_hash {
+struct sketch {
+	int i;			/* position of the next fingerprint */
+	int size;		/* entries in use */
+	uint64_t threshold;	/* root's hash, once size == sketch_k */
+	struct sketch_entry {
 		int index;
 		uint64_t hash;
 		uint64_t offset_hash;
-	} max_hashes[4];
+	} entries[SKETCH_MAX];
+	uint16_t heap[SKETCH_MAX];	/* entries, as a min-heap by hash */
+	struct {
+		int index;
+		uint16_t entry;
+	} ring[SKETCH_RING];
 };
 
-static int stor_index = 0;
-struct chunk_hash *hashes;
-
 #define parent(i) (i-1)/2
 #define left(i)	  (i*2+1)
 #define right(i)  (i*2+2)
 
-static void swap(struct max_hash *h1, struct max_hash *h2)
+#define heap_hash(sk, n) ((sk)->entries[(sk)->heap[n]].hash)
+
+static void sketch_reset(struct sketch *sk)
 {
-	struct max_hash temp = *h1;
-	*h1 = *h2;
-	*h2 = temp;
+	int r;
+
+	sk->i = 0;
+	sk->size = 0;
+	for (r = 0; r < SKETCH_RING; r++)
+		sk->ring[r].index = INT_MIN;
 }
 
-void min_heapify(struct max_array *ctx, int i)
+static void sketch_sift_down(struct sketch *sk, int i)
 {
-	int left_idx = left(i);
-	int right_idx = right(i);
-	int smallest = i;
-	if (left_idx < ctx->size && ctx->max_hashes[left_idx].hash < ctx->max_hashes[i].hash)
-		smallest = left_idx;
-	if (right_idx < ctx->size && ctx->max_hashes[right_idx].hash < ctx->max_hashes[smallest].hash)
-		smallest = right_idx;
-	if (smallest != i) {
-		swap(&ctx->max_hashes[i], &ctx->max_hashes[smallest]);
-		min_heapify(ctx, smallest);
+	for (;;) {
+		int left_idx = left(i);
+		int right_idx = right(i);
+		int smallest = i;
+		uint16_t tmp;
 
+		if (left_idx < sk->size && heap_hash(sk, left_idx) < heap_hash(sk, i))
+			smallest = left_idx;
+		if (right_idx < sk->size && heap_hash(sk, right_idx) < heap_hash(sk, smallest))
+			smallest = right_idx;
+		if (smallest == i)
+			return;
+		tmp = sk->heap[i];
+		sk->heap[i] = sk->heap[smallest];
+		sk->heap[smallest] = tmp;
+		i = smallest;
 	}
 }
 
-static void pop_heap(struct max_array *ctx)
+/* put fingerprint 'idx' in entry 'e' and add that to the heap */
+static void sketch_push(struct sketch *sk, int e, int idx, uint64_t hash)
 {
-	ctx->max_hashes[0] = ctx->max_hashes[--ctx->size];
-	assert(ctx->size >= 0 && ctx->size <= 3);
-	min_heapify(ctx, 0);
-}
+	int k = sk->size++;
 
-static void add_heap(struct max_array *ctx, int i, uint64_t hash)
-{
-	int k = ctx->size++;
-	assert(k>= 0 && k<=3);
-	// insert at the end
-	ctx->max_hashes[k].hash = hash;
-	ctx->max_hashes[k].index = i;
-	ctx->max_hashes[k].offset_hash = 0;
+	sk->entries[e].index = idx;
+	sk->entries[e].hash = hash;
+	sk->entries[e].offset_hash = 0;
 
-	while (k != 0 && ctx->max_hashes[parent(k)].hash > ctx->max_hashes[k].hash) {
-		swap(&ctx->max_hashes[k], &ctx->max_hashes[parent(k)]);
+	while (k != 0 && heap_hash(sk, parent(k)) > hash) {
+		sk->heap[k] = sk->heap[parent(k)];
 		k = parent(k);
 	}
+	sk->heap[k] = e;
 
+	sk->ring[idx & (SKETCH_RING - 1)].index = idx;
+	sk->ring[idx & (SKETCH_RING - 1)].entry = e;
+	if (sk->size == sketch_k)
+		sk->threshold = heap_hash(sk, 0);
 }
 
-static void insert_hash(struct max_array *ctx, uint64_t hash)
+/* the root drops out and its entry is reused */
+static void sketch_replace(struct sketch *sk, int idx, uint64_t hash)
 {
-	int idx = ctx->i++;
+	int e = sk->heap[0];
+
+	sk->heap[0] = sk->heap[--sk->size];
+	sketch_sift_down(sk, 0);
+	sketch_push(sk, e, idx, hash);
+}
+
+static inline void insert_hash(struct sketch *sk, uint64_t fp)
+{
+	int idx = sk->i++;
+	uint64_t hash = sketch_bottom ? ~fp : fp;
+	int prev = idx - M_OFFSET;
+	int e;
+
 	assert(idx < NUM_HASHES);
 
-	if (ctx->size < 4) {
-		add_heap(ctx, idx, hash);
+	if (sk->size < sketch_k) {
+		sketch_push(sk, sk->size, idx, hash);
+	} else if (hash > sk->threshold) {
+		sketch_replace(sk, idx, hash);
+	} else if (sk->ring[prev & (SKETCH_RING - 1)].index == prev) {
+		/* if that entry is still in, this is its offset hash */
+		e = sk->ring[prev & (SKETCH_RING - 1)].entry;
+		if (sk->entries[e].index == prev)
+			sk->entries[e].offset_hash = fp;
+	}
+}
+
+/*
+ * Hashing runs on a pool of worker threads.  Each worker has its own
+ * deque of work items: it pushes and pops at the bottom, and idle
+ * workers steal from the top of someone else's.  A work item is either
+ * a whole file, which the worker that gets it splits into chunks, or
+ * one CHUNK_SIZE chunk of a file.  Chunks are pushed so that the owner
+ * carries on through the file in order while thieves take chunks from
+ * the far end.  Files come from the directory walker through a shared
+ * queue that's taken from in order, so they're started in the order
+ * the walker found them.
+ *
+ * The deques and the counters used to put idle workers to sleep are
+ * protected by mutexes; that's a lock or two per 8M chunk, which is
+ * nothing next to hashing it.
+ */
+
+struct file_work {
+	uint32_t id;			/* in the path arena */
+	const char *filename;
+	const struct db_file *old;	/* unchanged since the database */
+	int fd;
+	off_t size;
+	loff_t nchunks;
+	int refs;			/* chunks not yet hashed */
+	struct timespec begin;
+	uint64_t read_ns, hash_ns;	/* summed over all workers */
+};
+
+struct work {
+	struct file_work *file;
+	loff_t chunk;			/* -1: split the file */
+};
+
+struct deque {
+	pthread_mutex_t lock;
+	struct work *items;
+	size_t top, bottom, size;	/* items[top..bottom) are queued */
+};
+
+/* a chunk read, from the time it's started until it's hashed */
+struct io_req {
+	struct file_work *file;
+	loff_t chunk;
+	char *buf;			/* CHUNK_SIZE, from rp_buffer_get() */
+	size_t done;			/* bytes read so far */
+	int error;			/* errno, or -1 for a short file */
+	struct worker *w;
+	struct io_req *next;		/* on a free, queued or done list */
+};
+
+/* the parts of an io_uring we use, as mapped from the kernel */
+struct uring {
+	int fd;
+	unsigned *sq_tail, *sq_mask, *sq_array;
+	unsigned *cq_head, *cq_tail, *cq_mask;
+	struct io_uring_sqe *sqes;
+	struct io_uring_cqe *cqes;
+	void *sq_ring, *cq_ring;
+	size_t sq_ring_size, cq_ring_size, sqes_size;
+};
+
+#define MAX_DEPTH 16
+
+struct worker {
+	pthread_t tid;
+	int id;
+	struct deque dq;
+	struct io_req reqs[MAX_DEPTH];	/* one per buffer */
+	struct io_req *io_free;
+	int inflight;			/* reads started and not hashed */
+	struct uring ring;
+	pthread_mutex_t io_lock;	/* reads done by reader threads */
+	pthread_cond_t io_wake;
+	struct io_req *io_done;
+	uint64_t *fps;
+	struct sketch sketch;
+	RabinPoly *rp;			/* only its tables are used */
+	struct match *matches;		/* candidate pairs it found */
+	size_t nmatches, matches_size;
+};
+
+static struct pool {
+	pthread_mutex_t lock;
+	pthread_cond_t wake;
+	pthread_cond_t room;
+	struct worker *workers;
+	int nworkers;
+	struct deque files;		/* from the walker, oldest first */
+	long pending;			/* queued or being worked on */
+	long queued;
+	int open_files;			/* queued or being hashed */
+	int done;			/* no more files coming */
+} pool = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.wake = PTHREAD_COND_INITIALIZER,
+	.room = PTHREAD_COND_INITIALIZER,
+	.files = { .lock = PTHREAD_MUTEX_INITIALIZER },
+};
+
+/* the walker waits for files to finish once this many are open */
+#define MAX_OPEN_FILES 256
+
+/*
+ * Chunk signatures, stored column by column: each of the sketch_k unit
+ * hashes, the chunk offset and the id of the file the chunk came from
+ * has an array of its own, so a pass over one hash reads nothing else.
+ *
+ * Workers add rows without locking: a row is claimed with an atomic
+ * increment.  Rows live in segments that double in size (row i is in
+ * segment log2(i / SIG_BASE + 1)), so the store grows geometrically
+ * but never moves a row; a segment is allocated by whoever needs it
+ * first.  Each row also has a link column per unit hash, which belong
+ * to the similarity index below.
+ */
+#define SIG_BASE 1024
+#define SIG_SEGS 40
+
+/* the columns after the unit hashes */
+#define SIG_OFF (sketch_k)
+#define SIG_LINK(c) (sketch_k + 1 + (c))
+
+/* bytes per row, over all columns */
+#define SIG_ROW ((2 * sketch_k + 1) * sizeof(uint64_t) + sizeof(uint32_t))
+
+static struct {
+	unsigned char *seg[SIG_SEGS];	/* holds all columns of the segment */
+	size_t count;
+} sigs;
+
+static inline size_t sig_seg_rows(int k)
+{
+	return (size_t)SIG_BASE << k;
+}
+
+/* segment of row 'idx', and its position in there */
+static inline int sig_locate(size_t idx, size_t *pos)
+{
+	int k = 63 - __builtin_clzll(idx / SIG_BASE + 1);
+
+	*pos = idx - SIG_BASE * ((1UL << k) - 1);
+	return k;
+}
+
+/* column 0 to sketch_k - 1: unit hashes, then SIG_OFF and SIG_LINK() */
+static inline uint64_t *sig_col(int k, int c)
+{
+	return (uint64_t *)sigs.seg[k] + c * sig_seg_rows(k);
+}
+
+static inline uint32_t *sig_file_col(int k)
+{
+	return (uint32_t *)sig_col(k, 2 * sketch_k + 1);
+}
+
+/* returns the new row's index */
+static size_t sig_append(uint32_t file, uint64_t off, const uint64_t *hashes)
+{
+	size_t idx = __atomic_fetch_add(&sigs.count, 1, __ATOMIC_RELAXED);
+	unsigned char *seg, *new;
+	size_t pos;
+	int k = sig_locate(idx, &pos);
+	int c;
+
+	assert(k < SIG_SEGS);
+	seg = __atomic_load_n(&sigs.seg[k], __ATOMIC_ACQUIRE);
+	if (!seg) {
+		new = malloc(sig_seg_rows(k) * SIG_ROW);
+		assert(new);
+		if (!__atomic_compare_exchange_n(&sigs.seg[k], &seg, new, 0,
+						 __ATOMIC_ACQ_REL,
+						 __ATOMIC_ACQUIRE))
+			free(new);
+	}
+	for (c = 0; c < sketch_k; c++)
+		sig_col(k, c)[pos] = hashes[c];
+	sig_col(k, SIG_OFF)[pos] = off;
+	sig_file_col(k)[pos] = file;
+	return idx;
+}
+
+static void sig_free(void)
+{
+	int k;
+
+	for (k = 0; k < SIG_SEGS; k++) {
+		free(sigs.seg[k]);
+		sigs.seg[k] = NULL;
+	}
+	sigs.count = 0;
+}
+
+/*
+ * File paths, each stored once in an arena of large blocks and named
+ * by a 32 bit id.  Only the walker adds paths, and a path never moves
+ * once added, so workers can keep pointers into the arena.
+ */
+#define ARENA_BLOCK (256*1024)
+
+static struct {
+	char *block;		/* newest block; starts with the previous one */
+	size_t used, size;
+	const char **paths;	/* by id */
+	uint32_t count, max;
+} arena;
+
+static uint32_t path_intern(const char *dir, const char *name)
+{
+	size_t dlen = strlen(dir), nlen = strlen(name);
+	size_t len = dlen + 1 + nlen + 1;
+	char *p;
+
+	if (arena.used + len > arena.size) {
+		size_t size = sizeof(char *) +
+			      (len > ARENA_BLOCK ? len : ARENA_BLOCK);
+		char *block = malloc(size);
+
+		assert(block);
+		*(char **)block = arena.block;
+		arena.block = block;
+		arena.used = sizeof(char *);
+		arena.size = size;
+	}
+	if (arena.count == arena.max) {
+		arena.max = arena.max ? arena.max * 2 : 1024;
+		arena.paths = realloc(arena.paths,
+				      arena.max * sizeof(*arena.paths));
+		assert(arena.paths);
+	}
+
+	p = arena.block + arena.used;
+	memcpy(p, dir, dlen);
+	p[dlen] = '/';
+	memcpy(p + dlen + 1, name, nlen + 1);
+	arena.used += len;
+
+	arena.paths[arena.count] = p;
+	return arena.count++;
+}
+
+static void path_free(void)
+{
+	while (arena.block) {
+		char *prev = *(char **)arena.block;
+
+		free(arena.block);
+		arena.block = prev;
+	}
+	free(arena.paths);
+	memset(&arena, 0, sizeof(arena));
+}
+
+/*
+ * Near-duplicate matching.  Chunks that share unit hashes most likely
+ * share content, so there's an inverted index from unit hash to the
+ * chunks that have it: per shard, a hash table from unit hash to the
+ * newest such chunk, and from there a list through the link columns
+ * of the sig store.  A node in such a list is a row and the column
+ * the hash is in (row * sketch_k + c), plus one so that 0 can end the
+ * list.
+ *
+ * Chunks are matched as they're added: the new chunk's hashes are
+ * looked up, each earlier chunk that has at least match_k of them
+ * makes a candidate pair, and then the new chunk is inserted.  All
+ * the shards its hashes fall in are held over both steps, so of two
+ * chunks added at once, one sees all of the other's hashes.  Only
+ * chunks that share a hash are ever compared; if very many share one,
+ * only the newest MAX_CHAIN of them are.
+ */
+#define INDEX_SHARDS 256
+#define MAX_CHAIN 64
+
+/* how many unit hashes a candidate pair shares, at least */
+static int match_k = 2;
+
+static struct index_shard {
+	pthread_mutex_t lock;
+	uint64_t *keys;
+	uint64_t *heads;	/* newest node + 1; 0: free slot */
+	size_t size, used;
+} shards[INDEX_SHARDS];
+
+struct match {
+	size_t a, b;		/* rows, a < b */
+	int shared;
+};
+
+static inline uint64_t *sig_at(size_t idx, int c)
+{
+	size_t pos;
+	int k = sig_locate(idx, &pos);
+
+	return &sig_col(k, c)[pos];
+}
+
+static inline uint32_t sig_file(size_t idx)
+{
+	size_t pos;
+	int k = sig_locate(idx, &pos);
+
+	return sig_file_col(k)[pos];
+}
+
+/* unit hashes are picked for being extreme, not for being uniform */
+static inline uint64_t index_mix(uint64_t hash)
+{
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdULL;
+	hash ^= hash >> 33;
+	return hash;
+}
+
+static inline int index_shard_of(uint64_t hash)
+{
+	return index_mix(hash) >> 56;
+}
+
+static size_t index_slot(const struct index_shard *sh, uint64_t hash)
+{
+	size_t i = index_mix(hash) & (sh->size - 1);
+
+	while (sh->heads[i] && sh->keys[i] != hash)
+		i = (i + 1) & (sh->size - 1);
+	return i;
+}
+
+/* make room for 'more' new keys, keeping the table at most half full */
+static void index_reserve(struct index_shard *sh, size_t more)
+{
+	uint64_t *keys = sh->keys, *heads = sh->heads;
+	size_t size = sh->size, i;
+
+	if ((sh->used + more) * 2 <= sh->size)
+		return;
+
+	sh->size = size ? size * 2 : 64;
+	sh->keys = malloc(sh->size * sizeof(*sh->keys));
+	sh->heads = calloc(sh->size, sizeof(*sh->heads));
+	assert(sh->keys && sh->heads);
+	for (i = 0; i < size; i++) {
+		if (heads[i]) {
+			size_t j = index_slot(sh, keys[i]);
+
+			sh->keys[j] = keys[i];
+			sh->heads[j] = heads[i];
+		}
+	}
+	free(keys);
+	free(heads);
+}
+
+static int cmp_row(const void *a, const void *b)
+{
+	size_t ra = *(const size_t *)a, rb = *(const size_t *)b;
+
+	return ra < rb ? -1 : ra > rb;
+}
+
+static void index_init(void)
+{
+	int i;
+
+	for (i = 0; i < INDEX_SHARDS; i++)
+		pthread_mutex_init(&shards[i].lock, NULL);
+}
+
+static void index_free(void)
+{
+	int i;
+
+	for (i = 0; i < INDEX_SHARDS; i++) {
+		free(shards[i].keys);
+		free(shards[i].heads);
+	}
+}
+
+static void add_match(struct worker *w, size_t a, size_t b, int shared)
+{
+	if (w->nmatches == w->matches_size) {
+		w->matches_size = w->matches_size ? w->matches_size * 2 : 256;
+		w->matches = realloc(w->matches,
+				     w->matches_size * sizeof(*w->matches));
+		assert(w->matches);
+	}
+	w->matches[w->nmatches].a = a;
+	w->matches[w->nmatches].b = b;
+	w->matches[w->nmatches].shared = shared;
+	w->nmatches++;
+}
+
+/* match row 'row' against the index, then add it */
+static void index_add(struct worker *w, size_t row, const uint64_t *hashes)
+{
+	size_t cand[SKETCH_MAX * MAX_CHAIN];
+	int col[SKETCH_MAX], shard[SKETCH_MAX];
+	int nh = 0, ns = 0, n = 0;
+	int i, j;
+
+	/* each distinct hash once; 0 means the chunk didn't have one */
+	for (i = 0; i < sketch_k; i++) {
+		if (!hashes[i])
+			continue;
+		for (j = 0; j < nh && hashes[col[j]] != hashes[i]; j++)
+			;
+		if (j == nh)
+			col[nh++] = i;
+	}
+
+	/* lock the shards involved in order, so nobody deadlocks */
+	for (i = 0; i < nh; i++) {
+		int s = index_shard_of(hashes[col[i]]);
+
+		for (j = 0; j < ns && shard[j] != s; j++)
+			;
+		if (j < ns)
+			continue;
+		for (j = ns; j > 0 && shard[j - 1] > s; j--)
+			shard[j] = shard[j - 1];
+		shard[j] = s;
+		ns++;
+	}
+	for (i = 0; i < ns; i++) {
+		pthread_mutex_lock(&shards[shard[i]].lock);
+		index_reserve(&shards[shard[i]], nh);
+	}
+
+	for (i = 0; i < nh; i++) {
+		uint64_t hash = hashes[col[i]];
+		struct index_shard *sh = &shards[index_shard_of(hash)];
+		size_t slot = index_slot(sh, hash);
+		uint64_t node = sh->heads[slot];
+		int walked;
+
+		for (walked = 0; node && walked < MAX_CHAIN; walked++) {
+			cand[n++] = (node - 1) / sketch_k;
+			node = *sig_at((node - 1) / sketch_k,
+				       SIG_LINK((node - 1) % sketch_k));
+		}
+	}
+	for (i = 0; i < nh; i++) {
+		uint64_t hash = hashes[col[i]];
+		struct index_shard *sh = &shards[index_shard_of(hash)];
+		size_t slot = index_slot(sh, hash);
+
+		if (!sh->heads[slot]) {
+			sh->keys[slot] = hash;
+			sh->used++;
+		}
+		*sig_at(row, SIG_LINK(col[i])) = sh->heads[slot];
+		sh->heads[slot] = row * sketch_k + col[i] + 1;
+	}
+
+	for (i = ns - 1; i >= 0; i--)
+		pthread_mutex_unlock(&shards[shard[i]].lock);
+
+	/* a row turns up once for each hash it shares with ours */
+	qsort(cand, n, sizeof(*cand), cmp_row);
+	for (i = 0; i < n; i = j) {
+		for (j = i + 1; j < n && cand[j] == cand[i]; j++)
+			;
+		if (j - i >= match_k)
+			add_match(w, cand[i], row, j - i);
+	}
+}
+
+/*
+ * The signature database (-d).  It's written at the end of a run and
+ * mapped read-only by the next one, which takes the signatures of any
+ * file whose size, mtime and inode are unchanged from it instead of
+ * hashing the file again.  The layout is meant to be used in place,
+ * with no parsing: a header, then the file records sorted by a hash of
+ * their path, then the chunk columns (the sketch_k unit hashes and the
+ * offsets, each an array of nchunks), then the paths.  All counts and
+ * offsets are 64 bit, everything up to the paths is 8 byte aligned,
+ * and integers are in host byte order; a database from a machine of
+ * the other endianness fails the magic check and is ignored.
+ */
+#define DB_MAGIC 0x31304244484d4953ULL	/* "SIMHDB01" on little endian */
+#define DB_VERSION 2
+
+struct db_header {
+	uint64_t magic;
+	uint32_t version;
+	uint32_t engine;
+	uint32_t sketch_k;
+	uint32_t sketch_bottom;
+	uint64_t chunk_size;
+	uint64_t nfiles;
+	uint64_t nchunks;
+	uint64_t files_off;		/* struct db_file[nfiles] */
+	uint64_t hashes_off;		/* uint64_t[sketch_k][nchunks] */
+	uint64_t offs_off;		/* uint64_t[nchunks] */
+	uint64_t paths_off;		/* NUL terminated strings */
+	uint64_t size;			/* of the whole database */
+};
+
+struct db_file {
+	uint64_t path_hash;
+	uint64_t path_off;		/* from paths_off */
+	uint64_t dev, ino;
+	uint64_t size;
+	uint64_t mtime_ns;
+	uint64_t first_chunk;		/* its chunks, in offset order */
+	uint64_t nchunks;
+};
+
+/* the database from the last run, if any */
+static struct {
+	const unsigned char *map;
+	size_t size;
+	const struct db_header *hdr;
+	const struct db_file *files;
+	const uint64_t *hashes;
+	const uint64_t *offs;
+	const char *paths;
+} old_db;
+
+/* stat data of each file found, by path id; filled by the walker */
+static struct db_meta {
+	uint64_t dev, ino, size, mtime_ns;
+} *metas;
+static uint32_t metas_size;
+
+static uint64_t path_hash(const char *path)
+{
+	uint64_t h = 0xcbf29ce484222325ULL;	/* FNV-1a */
+
+	while (*path)
+		h = (h ^ (unsigned char)*path++) * 0x100000001b3ULL;
+	return h;
+}
+
+static void db_record(uint32_t id, const struct stat *st)
+{
+	if (id >= metas_size) {
+		metas_size = arena.max;
+		metas = realloc(metas, metas_size * sizeof(*metas));
+		assert(metas);
+	}
+	metas[id].dev = st->st_dev;
+	metas[id].ino = st->st_ino;
+	metas[id].size = st->st_size;
+	metas[id].mtime_ns = st->st_mtim.tv_sec * 1000000000ULL +
+			     st->st_mtim.tv_nsec;
+}
+
+static int db_open(const char *path)
+{
+	const struct db_header *hdr;
+	struct stat st;
+	void *map;
+	int fd;
+
+	fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		if (errno != ENOENT)
+			fprintf(stderr, "Error %d: %s while opening %s\n",
+				errno, strerror(errno), path);
+		return -1;
+	}
+	if (fstat(fd, &st) || st.st_size < (off_t)sizeof(*hdr)) {
+		close(fd);
+		fprintf(stderr, "%s is not a signature database. Ignoring it.\n",
+			path);
+		return -1;
+	}
+	map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED)
+		return -1;
+
+	hdr = map;
+	if (hdr->magic != DB_MAGIC || hdr->version != DB_VERSION ||
+	    hdr->size != (uint64_t)st.st_size ||
+	    hdr->files_off + hdr->nfiles * sizeof(struct db_file) > hdr->hashes_off ||
+	    hdr->hashes_off + hdr->sketch_k * hdr->nchunks * sizeof(uint64_t) > hdr->offs_off ||
+	    hdr->offs_off + hdr->nchunks * sizeof(uint64_t) > hdr->paths_off ||
+	    hdr->paths_off > hdr->size) {
+		fprintf(stderr, "%s is not a signature database. Ignoring it.\n",
+			path);
+		munmap(map, st.st_size);
+		return -1;
+	}
+	if (hdr->engine != (uint32_t)engine || hdr->chunk_size != CHUNK_SIZE ||
+	    hdr->sketch_k != (uint32_t)sketch_k ||
+	    hdr->sketch_bottom != (uint32_t)sketch_bottom) {
+		fprintf(stderr, "%s was made with other settings. Ignoring it.\n",
+			path);
+		munmap(map, st.st_size);
+		return -1;
+	}
+
+	old_db.map = map;
+	old_db.size = st.st_size;
+	old_db.hdr = hdr;
+	old_db.files = (const void *)(old_db.map + hdr->files_off);
+	old_db.hashes = (const void *)(old_db.map + hdr->hashes_off);
+	old_db.offs = (const void *)(old_db.map + hdr->offs_off);
+	old_db.paths = (const char *)old_db.map + hdr->paths_off;
+	return 0;
+}
+
+/* the old record of file 'id' if the file hasn't changed since */
+static const struct db_file *db_lookup(uint32_t id)
+{
+	const char *path = arena.paths[id];
+	const struct db_meta *m = &metas[id];
+	uint64_t h = path_hash(path);
+	size_t lo = 0, hi;
+
+	if (!old_db.map)
+		return NULL;
+
+	hi = old_db.hdr->nfiles;
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+
+		if (old_db.files[mid].path_hash < h)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	for (; lo < old_db.hdr->nfiles && old_db.files[lo].path_hash == h; lo++) {
+		const struct db_file *f = &old_db.files[lo];
+
+		if (f->path_off >= old_db.size - old_db.hdr->paths_off ||
+		    f->first_chunk + f->nchunks > old_db.hdr->nchunks ||
+		    strncmp(old_db.paths + f->path_off, path,
+			    old_db.size - old_db.hdr->paths_off - f->path_off))
+			continue;
+		if (f->dev == m->dev && f->ino == m->ino &&
+		    f->size == m->size && f->mtime_ns == m->mtime_ns &&
+		    f->nchunks == m->size / CHUNK_SIZE)
+			return f;
+		return NULL;
+	}
+	return NULL;
+}
+
+static int cmp_file_row(const void *a, const void *b)
+{
+	size_t ra = *(const size_t *)a, rb = *(const size_t *)b;
+	uint32_t fa = sig_file(ra), fb = sig_file(rb);
+
+	if (fa != fb)
+		return fa < fb ? -1 : 1;
+	return *sig_at(ra, SIG_OFF) < *sig_at(rb, SIG_OFF) ? -1 :
+	       *sig_at(ra, SIG_OFF) > *sig_at(rb, SIG_OFF);
+}
+
+/* a file to save, and where its rows are */
+struct db_entry {
+	struct db_file f;
+	uint32_t id;
+	size_t from;			/* into the sorted rows */
+};
+
+static int cmp_db_entry(const void *a, const void *b)
+{
+	const struct db_entry *ea = a, *eb = b;
+
+	return ea->f.path_hash < eb->f.path_hash ? -1 :
+	       ea->f.path_hash > eb->f.path_hash;
+}
+
+static int db_write(FILE *f, const void *p, size_t size)
+{
+	return fwrite(p, 1, size, f) == size ? 0 : -1;
+}
+
+/*
+ * Write what this run found to 'path', through a temporary file so
+ * the old database stays intact until the new one is complete.  Files
+ * that weren't hashed completely are left out, so they're hashed again
+ * next time.
+ */
+static int db_save(const char *path)
+{
+	struct db_header hdr = { .magic = DB_MAGIC, .version = DB_VERSION };
+	size_t nrows = sigs.count, nfiles = 0, nchunks = 0, paths_size = 0;
+	struct db_entry *files;
+	size_t *rows, i, r;
+	char *tmp;
+	FILE *f;
+	int c, ret = -1;
+
+	rows = malloc((nrows ? nrows : 1) * sizeof(*rows));
+	files = malloc((arena.count ? arena.count : 1) * sizeof(*files));
+	tmp = malloc(strlen(path) + 5);
+	assert(rows && files && tmp);
+	sprintf(tmp, "%s.tmp", path);
+
+	/* each file's rows together, in offset order */
+	for (r = 0; r < nrows; r++)
+		rows[r] = r;
+	qsort(rows, nrows, sizeof(*rows), cmp_file_row);
+
+	for (i = 0, r = 0; i < arena.count; i++) {
+		struct db_entry *e = &files[nfiles];
+		size_t from = r;
+
+		while (r < nrows && sig_file(rows[r]) == i)
+			r++;
+		if (r - from != metas[i].size / CHUNK_SIZE)
+			continue;
+		e->id = i;
+		e->from = from;
+		e->f.path_hash = path_hash(arena.paths[i]);
+		e->f.dev = metas[i].dev;
+		e->f.ino = metas[i].ino;
+		e->f.size = metas[i].size;
+		e->f.mtime_ns = metas[i].mtime_ns;
+		e->f.nchunks = r - from;
+		nfiles++;
+	}
+	qsort(files, nfiles, sizeof(*files), cmp_db_entry);
+	for (i = 0; i < nfiles; i++) {
+		files[i].f.path_off = paths_size;
+		files[i].f.first_chunk = nchunks;
+		paths_size += strlen(arena.paths[files[i].id]) + 1;
+		nchunks += files[i].f.nchunks;
+	}
+
+	hdr.engine = engine;
+	hdr.sketch_k = sketch_k;
+	hdr.sketch_bottom = sketch_bottom;
+	hdr.chunk_size = CHUNK_SIZE;
+	hdr.nfiles = nfiles;
+	hdr.nchunks = nchunks;
+	hdr.files_off = sizeof(hdr);
+	hdr.hashes_off = hdr.files_off + nfiles * sizeof(struct db_file);
+	hdr.offs_off = hdr.hashes_off + sketch_k * nchunks * sizeof(uint64_t);
+	hdr.paths_off = hdr.offs_off + nchunks * sizeof(uint64_t);
+	hdr.size = hdr.paths_off + paths_size;
+
+	f = fopen(tmp, "w");
+	if (!f) {
+		fprintf(stderr, "Error %d: %s while creating %s\n",
+			errno, strerror(errno), tmp);
+		goto out;
+	}
+	if (db_write(f, &hdr, sizeof(hdr)))
+		goto fail;
+	for (i = 0; i < nfiles; i++)
+		if (db_write(f, &files[i].f, sizeof(files[i].f)))
+			goto fail;
+	/* the unit hashes, then the offsets */
+	for (c = 0; c <= SIG_OFF; c++)
+		for (i = 0; i < nfiles; i++)
+			for (r = files[i].from;
+			     r < files[i].from + files[i].f.nchunks; r++)
+				if (db_write(f, sig_at(rows[r], c),
+					     sizeof(uint64_t)))
+					goto fail;
+	for (i = 0; i < nfiles; i++) {
+		const char *p = arena.paths[files[i].id];
+
+		if (db_write(f, p, strlen(p) + 1))
+			goto fail;
+	}
+	if (fclose(f)) {
+		f = NULL;
+		goto fail;
+	}
+	f = NULL;
+	if (rename(tmp, path))
+		goto fail;
+	ret = 0;
+	goto out;
+fail:
+	fprintf(stderr, "Error %d: %s while writing %s\n",
+		errno, strerror(errno), tmp);
+	if (f)
+		fclose(f);
+	unlink(tmp);
+out:
+	free(rows);
+	free(files);
+	free(tmp);
+	return ret;
+}
+
+static void db_close(void)
+{
+	if (old_db.map)
+		munmap((void *)old_db.map, old_db.size);
+	memset(&old_db, 0, sizeof(old_db));
+	free(metas);
+	metas = NULL;
+	metas_size = 0;
+}
+
+static uint64_t ns_since(const struct timespec *begin)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (now.tv_sec - begin->tv_sec) * 1000000000ULL +
+		now.tv_nsec - begin->tv_nsec;
+}
+
+static void deque_push(struct deque *dq, struct work item)
+{
+	pthread_mutex_lock(&dq->lock);
+	if (dq->top == dq->bottom)
+		dq->top = dq->bottom = 0;
+	if (dq->bottom == dq->size) {
+		dq->size = dq->size ? dq->size * 2 : 64;
+		dq->items = realloc(dq->items, dq->size * sizeof(*dq->items));
+		assert(dq->items);
+	}
+	dq->items[dq->bottom++] = item;
+	pthread_mutex_unlock(&dq->lock);
+}
+
+static int deque_pop(struct deque *dq, struct work *item)
+{
+	int found = 0;
+
+	pthread_mutex_lock(&dq->lock);
+	if (dq->top != dq->bottom) {
+		*item = dq->items[--dq->bottom];
+		found = 1;
+	}
+	pthread_mutex_unlock(&dq->lock);
+	return found;
+}
+
+static int deque_steal(struct deque *dq, struct work *item)
+{
+	int found = 0;
+
+	pthread_mutex_lock(&dq->lock);
+	if (dq->top != dq->bottom) {
+		*item = dq->items[dq->top++];
+		found = 1;
+	}
+	pthread_mutex_unlock(&dq->lock);
+	return found;
+}
+
+static void push_work(struct deque *dq, struct file_work *file, loff_t chunk)
+{
+	struct work item = { file, chunk };
+
+	pthread_mutex_lock(&pool.lock);
+	pool.pending++;
+	pthread_mutex_unlock(&pool.lock);
+
+	deque_push(dq, item);
+
+	pthread_mutex_lock(&pool.lock);
+	pool.queued++;
+	pthread_cond_signal(&pool.wake);
+	pthread_mutex_unlock(&pool.lock);
+}
+
+static void work_done(void)
+{
+	pthread_mutex_lock(&pool.lock);
+	if (--pool.pending == 0)
+		pthread_cond_broadcast(&pool.wake);
+	pthread_mutex_unlock(&pool.lock);
+}
+
+/*
+ * Next item for w.  Returns 0 once everything is done, or, unless
+ * 'wait' is set, if there's nothing to do right now.
+ */
+static int take_work(struct worker *w, struct work *item, int wait)
+{
+	int i;
+
+	for (;;) {
+		int found = deque_pop(&w->dq, item) ||
+			    deque_steal(&pool.files, item);
+
+		for (i = 1; !found && i < pool.nworkers; i++)
+			found = deque_steal(&pool.workers[(w->id + i) %
+							 pool.nworkers].dq,
+					    item);
+
+		pthread_mutex_lock(&pool.lock);
+		if (found) {
+			pool.queued--;
+			pthread_mutex_unlock(&pool.lock);
+			return 1;
+		}
+		if (!wait || (pool.done && !pool.pending)) {
+			pthread_mutex_unlock(&pool.lock);
+			return 0;
+		}
+		if (!pool.queued)
+			pthread_cond_wait(&pool.wake, &pool.lock);
+		pthread_mutex_unlock(&pool.lock);
+	}
+}
+
+/* one less chunk to go in 'file'; the last one out reports and cleans up */
+static void file_put(struct file_work *file)
+{
+	double elapsed;
+	loff_t bytes;
+
+	if (__atomic_sub_fetch(&file->refs, 1, __ATOMIC_ACQ_REL))
+		return;
+
+	elapsed = ns_since(&file->begin) / 1e9;
+	bytes = file->nchunks * CHUNK_SIZE;
+
+	if (file->old)
+		printf("Reused hashes of %lu mb of %s\n",
+		       bytes / 1024 / 1024, file->filename);
+	else {
+		close(file->fd);
+		printf("Hashed %lu mb of %s in %f seconds(throughput: %f mb/s). Hash time: %f read time: %f\n",
+	       bytes / 1024 / 1024, file->filename,
+	       elapsed, (bytes / elapsed)/1024/1024,
+	       file->hash_ns / 1e9, file->read_ns / 1e9);
+	}
+
+	free(file);
+
+	pthread_mutex_lock(&pool.lock);
+	pool.open_files--;
+	pthread_cond_signal(&pool.room);
+	pthread_mutex_unlock(&pool.lock);
+}
+
+/*
+ * Chunk reads.  Each worker keeps up to io_depth chunks in flight and
+ * hashes one while the kernel reads the others, so a run takes about
+ * as long as the reading or the hashing, whichever is slower, rather
+ * than the two added up.  Reads go through an io_uring per worker, set
+ * up with raw system calls; where there is none (old kernels, seccomp
+ * filters), or with -P, a pool of reader threads does plain preads
+ * instead.  With -D, files are opened with O_DIRECT where the
+ * filesystem allows it, and the page aligned buffers can be read into
+ * without going through the page cache.
+ */
+static int io_depth = 2;
+static int use_uring = 1;
+static int direct_io;
+
+static struct {
+	pthread_mutex_t lock;
+	pthread_cond_t wake;
+	struct io_req *head, **tail;	/* reads not started yet */
+	pthread_t *tids;
+	int nthreads;
+	int stop;
+} readers = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.wake = PTHREAD_COND_INITIALIZER,
+	.tail = &readers.head,
+};
+
+static int uring_init(struct uring *ring, unsigned entries)
+{
+	struct io_uring_params p;
+
+	memset(&p, 0, sizeof(p));
+	ring->fd = syscall(__NR_io_uring_setup, entries, &p);
+	if (ring->fd < 0)
+		return -1;
+
+	ring->sq_ring_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+	ring->cq_ring_size = p.cq_off.cqes +
+			     p.cq_entries * sizeof(struct io_uring_cqe);
+	if (p.features & IORING_FEAT_SINGLE_MMAP) {
+		if (ring->cq_ring_size > ring->sq_ring_size)
+			ring->sq_ring_size = ring->cq_ring_size;
+		ring->cq_ring_size = ring->sq_ring_size;
+	}
+	ring->sq_ring = mmap(NULL, ring->sq_ring_size,
+			     PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+			     ring->fd, IORING_OFF_SQ_RING);
+	if (ring->sq_ring == MAP_FAILED)
+		goto fail;
+	if (p.features & IORING_FEAT_SINGLE_MMAP) {
+		ring->cq_ring = ring->sq_ring;
 	} else {
-		if (ctx->max_hashes[0].hash < hash) {
-			pop_heap(ctx);
-			add_heap(ctx, idx, hash);
-		} else {
-			if (idx == ctx->max_hashes[0].index + M_OFFSET)
-				ctx->max_hashes[0].offset_hash = hash;
-			else if (idx == ctx->max_hashes[1].index + M_OFFSET)
-				ctx->max_hashes[1].offset_hash = hash;
-			else if (idx == ctx->max_hashes[2].index + M_OFFSET)
-				ctx->max_hashes[2].offset_hash = hash;
-			else if (idx == ctx->max_hashes[3].index + M_OFFSET)
-				ctx->max_hashes[3].offset_hash = hash;
+		ring->cq_ring = mmap(NULL, ring->cq_ring_size,
+				     PROT_READ | PROT_WRITE,
+				     MAP_SHARED | MAP_POPULATE,
+				     ring->fd, IORING_OFF_CQ_RING);
+		if (ring->cq_ring == MAP_FAILED) {
+			munmap(ring->sq_ring, ring->sq_ring_size);
+			goto fail;
 		}
 	}
+	ring->sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+	ring->sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE,
+			  MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+	if (ring->sqes == MAP_FAILED) {
+		if (ring->cq_ring != ring->sq_ring)
+			munmap(ring->cq_ring, ring->cq_ring_size);
+		munmap(ring->sq_ring, ring->sq_ring_size);
+		goto fail;
+	}
+
+	ring->sq_tail = (unsigned *)((char *)ring->sq_ring + p.sq_off.tail);
+	ring->sq_mask = (unsigned *)((char *)ring->sq_ring + p.sq_off.ring_mask);
+	ring->sq_array = (unsigned *)((char *)ring->sq_ring + p.sq_off.array);
+	ring->cq_head = (unsigned *)((char *)ring->cq_ring + p.cq_off.head);
+	ring->cq_tail = (unsigned *)((char *)ring->cq_ring + p.cq_off.tail);
+	ring->cq_mask = (unsigned *)((char *)ring->cq_ring + p.cq_off.ring_mask);
+	ring->cqes = (struct io_uring_cqe *)((char *)ring->cq_ring + p.cq_off.cqes);
+	return 0;
+fail:
+	close(ring->fd);
+	ring->fd = -1;
+	return -1;
 }
 
+static void uring_exit(struct uring *ring)
+{
+	if (ring->fd < 0)
+		return;
+	munmap(ring->sqes, ring->sqes_size);
+	if (ring->cq_ring != ring->sq_ring)
+		munmap(ring->cq_ring, ring->cq_ring_size);
+	munmap(ring->sq_ring, ring->sq_ring_size);
+	close(ring->fd);
+	ring->fd = -1;
+}
 
-int find_largest(uint64_t *numbers)
+/* queue a read of the rest of req's chunk */
+static void uring_read(struct uring *ring, struct io_req *req)
 {
-	uint64_t largest = 0;
-	int found_index = 0;
-	for (int i = 0; i < NUM_HASHES; i++) {
-		if (numbers[i] > largest) {
-			largest = numbers[i];
-			found_index = i;
+	unsigned tail = *ring->sq_tail;
+	unsigned idx = tail & *ring->sq_mask;
+	struct io_uring_sqe *sqe = &ring->sqes[idx];
+
+	memset(sqe, 0, sizeof(*sqe));
+	sqe->opcode = IORING_OP_READ;
+	sqe->fd = req->file->fd;
+	sqe->addr = (uintptr_t)(req->buf + req->done);
+	sqe->len = CHUNK_SIZE - req->done;
+	sqe->off = req->chunk * CHUNK_SIZE + req->done;
+	sqe->user_data = (uintptr_t)req;
+	ring->sq_array[idx] = idx;
+	__atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+	while (syscall(__NR_io_uring_enter, ring->fd, 1, 0, 0, NULL, 0) < 0) {
+		if (errno != EINTR && errno != EAGAIN) {
+			/* can't happen with a ring of our own size */
+			perror("io_uring_enter");
+			exit(1);
 		}
 	}
+}
 
-	// so that we can call it multiple times and always get a larger value
-	numbers[found_index] = 0;
+/* the next read that's complete, reissuing any that came up short */
+static struct io_req *uring_wait(struct uring *ring)
+{
+	for (;;) {
+		unsigned head = *ring->cq_head;
+		struct io_uring_cqe *cqe;
+		struct io_req *req;
+
+		if (head == __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE)) {
+			if (syscall(__NR_io_uring_enter, ring->fd, 0, 1,
+				    IORING_ENTER_GETEVENTS, NULL, 0) < 0 &&
+			    errno != EINTR) {
+				perror("io_uring_enter");
+				exit(1);
+			}
+			continue;
+		}
+		cqe = &ring->cqes[head & *ring->cq_mask];
+		req = (struct io_req *)(uintptr_t)cqe->user_data;
+		if (cqe->res < 0)
+			req->error = -cqe->res;
+		else if (cqe->res == 0)
+			req->error = -1;
+		else
+			req->done += cqe->res;
+		__atomic_store_n(ring->cq_head, head + 1, __ATOMIC_RELEASE);
 
-	return found_index;
+		if (!req->error && req->done < CHUNK_SIZE) {
+			uring_read(ring, req);
+			continue;
+		}
+		return req;
+	}
 }
 
-int hash_chunk(int fd, loff_t chunk_off, char *filename)
+static void *reader_main(void *arg)
 {
-	static char filebuf[CHUNK_SIZE];
-	static struct max_array hash_list = {};
-	int i = 0;
-	int rc = 0;
-	struct chunk_hash *chunk = &hashes[stor_index++];
-	clock_t begin, end;
+	struct io_req *req;
 	ssize_t count;
 
-	RabinPoly *rp = rp_new(512,BUFSIZE,BUFSIZE,BUFSIZE,BUFSIZE, 0x3f63dfbf84af3b);
-	begin = clock();
-	count = read(fd, filebuf, CHUNK_SIZE);
-	end = clock();
+	(void)arg;
+	for (;;) {
+		pthread_mutex_lock(&readers.lock);
+		while (!readers.head && !readers.stop)
+			pthread_cond_wait(&readers.wake, &readers.lock);
+		req = readers.head;
+		if (!req) {
+			pthread_mutex_unlock(&readers.lock);
+			return NULL;
+		}
+		readers.head = req->next;
+		if (!readers.head)
+			readers.tail = &readers.head;
+		pthread_mutex_unlock(&readers.lock);
 
-	if (count != CHUNK_SIZE) {
-		if (count)
-			printf("Short chunk - skipping: %ld\n", count);
-		stor_index--;
-		return 1;
+		while (!req->error && req->done < CHUNK_SIZE) {
+			count = pread(req->file->fd, req->buf + req->done,
+				      CHUNK_SIZE - req->done,
+				      req->chunk * CHUNK_SIZE + req->done);
+			if (count < 0 && errno != EINTR)
+				req->error = errno;
+			else if (count == 0)
+				req->error = -1;
+			else if (count > 0)
+				req->done += count;
+		}
+
+		pthread_mutex_lock(&req->w->io_lock);
+		req->next = req->w->io_done;
+		req->w->io_done = req;
+		pthread_cond_signal(&req->w->io_wake);
+		pthread_mutex_unlock(&req->w->io_lock);
+	}
+}
+
+static int start_readers(int nthreads)
+{
+	readers.tids = calloc(nthreads, sizeof(*readers.tids));
+	if (!readers.tids)
+		return -1;
+	for (; readers.nthreads < nthreads; readers.nthreads++)
+		if (pthread_create(&readers.tids[readers.nthreads], NULL,
+				   reader_main, NULL))
+			return -1;
+	return 0;
+}
+
+static void stop_readers(void)
+{
+	int i;
+
+	pthread_mutex_lock(&readers.lock);
+	readers.stop = 1;
+	pthread_cond_broadcast(&readers.wake);
+	pthread_mutex_unlock(&readers.lock);
+	for (i = 0; i < readers.nthreads; i++)
+		pthread_join(readers.tids[i], NULL);
+	free(readers.tids);
+}
+
+/* start reading chunk 'chunk' of 'file' into one of w's free buffers */
+static void io_start(struct worker *w, struct file_work *file, loff_t chunk)
+{
+	struct io_req *req = w->io_free;
+
+	w->io_free = req->next;
+	w->inflight++;
+	req->file = file;
+	req->chunk = chunk;
+	req->done = 0;
+	req->error = 0;
+
+	if (use_uring) {
+		uring_read(&w->ring, req);
+		return;
+	}
+	pthread_mutex_lock(&readers.lock);
+	req->next = NULL;
+	*readers.tail = req;
+	readers.tail = &req->next;
+	pthread_cond_signal(&readers.wake);
+	pthread_mutex_unlock(&readers.lock);
+}
+
+/* wait for one of w's reads to finish; the time counts as read time */
+static struct io_req *io_wait(struct worker *w)
+{
+	struct timespec begin;
+	struct io_req *req;
+
+	clock_gettime(CLOCK_MONOTONIC, &begin);
+	if (use_uring) {
+		req = uring_wait(&w->ring);
+	} else {
+		pthread_mutex_lock(&w->io_lock);
+		while (!w->io_done)
+			pthread_cond_wait(&w->io_wake, &w->io_lock);
+		req = w->io_done;
+		w->io_done = req->next;
+		pthread_mutex_unlock(&w->io_lock);
 	}
+	__atomic_add_fetch(&req->file->read_ns, ns_since(&begin),
+			   __ATOMIC_RELAXED);
+	return req;
+}
 
-	read_elapsed += end - begin;
+static void io_release(struct worker *w, struct io_req *req)
+{
+	req->next = w->io_free;
+	w->io_free = req;
+	w->inflight--;
+}
 
-	rp_from_buffer(rp, filebuf, BUFSIZE);
-	strcpy(chunk->filename, filename);
+/* hash a chunk that's been read into 'buf' (NULL: reuse the old hashes) */
+int hash_chunk(struct worker *w, struct file_work *file, loff_t chunk_idx,
+	       const char *buf)
+{
+	struct sketch *sketch = &w->sketch;
+	loff_t chunk_off = chunk_idx * CHUNK_SIZE;
+	uint64_t unit_hashes[SKETCH_MAX];
+	struct timespec begin;
+	size_t off, i;
 
-	begin = clock();
-	// calculate first 512 bytes this fills our sliding window
-	for (i = 0; i < 512; i++)
-		calc_rabin(rp);
+	if (file->old) {
+		size_t row = file->old->first_chunk + chunk_idx;
 
-	// calculate every Ji'th hash sum and store it
-	while ((rc = calc_rabin(rp)) != EOF)
-		insert_hash(&hash_list, rp->fingerprint);
+		for (int c = 0; c < sketch_k; c++)
+			unit_hashes[c] = old_db.hashes[c * old_db.hdr->nchunks + row];
+		index_add(w, sig_append(file->id, chunk_off, unit_hashes),
+			  unit_hashes);
+		return 0;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &begin);
+	sketch_reset(sketch);
+	// the first 512 bytes fill our sliding window, store every hash
+	// sum after that. rp_fingerprints() computes them in parallel
+	// lanes, so do it in batches rather than a byte at a time.
+	for (off = 512; off < CHUNK_SIZE; off += FP_BATCH) {
+		size_t stop = off + FP_BATCH < CHUNK_SIZE ? off + FP_BATCH : CHUNK_SIZE;
+
+		rp_fingerprints(w->rp, buf, off, stop, w->fps);
+		for (i = 0; i < stop - off; i++)
+			insert_hash(sketch, w->fps[i]);
+	}
 
 
 	// This finds the indexes and shifts them by
 	// M_OFFSET
-	for (int c = 0; c < 4; c++)
-		chunk->unit_hashes[c] = hash_list.max_hashes[c].offset_hash;
-	chunk->off = chunk_off;
-	end = clock();
+	for (int c = 0; c < sketch_k; c++)
+		unit_hashes[c] = sketch->entries[sketch->heap[c]].offset_hash;
+	index_add(w, sig_append(file->id, chunk_off, unit_hashes), unit_hashes);
+	__atomic_add_fetch(&file->hash_ns, ns_since(&begin), __ATOMIC_RELAXED);
 
-	hash_elapsed += end - begin;
+	return 0;
+}
+
+/*
+ * Queue a file's chunks on w's deque, highest offset first, keeping
+ * chunk 0 to start on right away.  Returns the number of that chunk,
+ * or -1 if there's nothing to hash.
+ */
+static loff_t split_file(struct worker *w, struct file_work *file)
+{
+	loff_t c;
+
+	if (!file->old)
+		printf("Hashing file %s\n", file->filename);
+	clock_gettime(CLOCK_MONOTONIC, &file->begin);
 
-	//Prep for next iteration
-	rp_free(rp);
-	hash_list.i = 0;
-	hash_list.size = 0;
+	file->nchunks = file->size / CHUNK_SIZE;
+	if (file->size % CHUNK_SIZE)
+		printf("Short chunk - skipping: %ld\n",
+		       (long)(file->size % CHUNK_SIZE));
 
+	file->refs = file->nchunks ? file->nchunks : 1;
+	if (!file->nchunks) {
+		file_put(file);
+		return -1;
+	}
+	for (c = file->nchunks - 1; c > 0; c--)
+		push_work(&w->dq, file, c);
 	return 0;
 }
 
-static int get_dirent_type(struct dirent *entry, int fd)
+static void *worker_main(void *arg)
+{
+	struct worker *w = arg;
+	struct work item;
+	struct io_req *req;
+
+	/*
+	 * Read buffers from librabinpoly's pool: huge pages, faulted in
+	 * by this thread so they're on its NUMA node, and 2 MiB aligned,
+	 * which is plenty for O_DIRECT.
+	 */
+	for (req = w->io_free; req; req = req->next) {
+		req->buf = rp_buffer_get(CHUNK_SIZE);
+		if (!req->buf) {
+			perror("read buffer");
+			exit(1);
+		}
+	}
+
+	for (;;) {
+		/* keep reads going; only wait for work with none going */
+		while (w->inflight < io_depth &&
+		       take_work(w, &item, !w->inflight)) {
+			loff_t chunk = item.chunk;
+
+			if (chunk < 0) {
+				/* the file's own item carries on as chunk 0 */
+				chunk = split_file(w, item.file);
+				if (chunk < 0) {
+					work_done();
+					continue;
+				}
+			}
+			if (item.file->old) {
+				hash_chunk(w, item.file, chunk, NULL);
+				file_put(item.file);
+				work_done();
+				continue;
+			}
+			io_start(w, item.file, chunk);
+		}
+		if (!w->inflight)
+			break;
+
+		req = io_wait(w);
+		if (req->error)
+			printf("Error reading %s at %lu: %s\n",
+			       req->file->filename,
+			       (unsigned long)(req->chunk * CHUNK_SIZE),
+			       req->error < 0 ? "short read" :
+			       strerror(req->error));
+		else
+			hash_chunk(w, req->file, req->chunk, req->buf);
+		file_put(req->file);
+		work_done();
+		io_release(w, req);
+	}
+	return NULL;
+}
+
+/*
+ * Queue an open file for hashing.  Takes over 'fd'; 'id' is the
+ * file's path in the arena.  If the database says the file hasn't
+ * changed, its old signatures are used and 'fd' is closed right away.
+ * Waits if too many files are in flight, so a big tree doesn't run us
+ * out of file descriptors.
+ */
+static int hash_file(int fd, off_t size, uint32_t id)
+{
+	struct file_work *file = calloc(1, sizeof(*file));
+
+	if (!file) {
+		printf("Error allocating memory");
+		close(fd);
+		return 1;
+	}
+	file->id = id;
+	file->filename = arena.paths[id];
+	file->old = db_lookup(id);
+	if (file->old) {
+		close(fd);
+		fd = -1;
+	}
+	file->fd = fd;
+	file->size = size;
+
+	pthread_mutex_lock(&pool.lock);
+	while (pool.open_files >= MAX_OPEN_FILES)
+		pthread_cond_wait(&pool.room, &pool.lock);
+	pool.open_files++;
+	pthread_mutex_unlock(&pool.lock);
+
+	push_work(&pool.files, file, -1);
+	return 0;
+}
+
+static int start_workers(int nworkers)
+{
+	int i;
+
+	pool.workers = calloc(nworkers, sizeof(*pool.workers));
+	if (!pool.workers)
+		return -1;
+	pool.nworkers = nworkers;
+
+	for (i = 0; i < nworkers; i++) {
+		struct worker *w = &pool.workers[i];
+		int d;
+
+		w->id = i;
+		pthread_mutex_init(&w->dq.lock, NULL);
+		pthread_mutex_init(&w->io_lock, NULL);
+		pthread_cond_init(&w->io_wake, NULL);
+		for (d = io_depth - 1; d >= 0; d--) {
+			struct io_req *req = &w->reqs[d];
+
+			/* the worker gets its buffers itself, see worker_main() */
+			req->buf = NULL;
+			req->w = w;
+			req->next = w->io_free;
+			w->io_free = req;
+		}
+		w->ring.fd = -1;
+		w->fps = malloc(FP_BATCH * sizeof(*w->fps));
+		/* no internal buffer needed, we scan the chunks in place */
+		w->rp = rp_new_engine(engine, 512, BUFSIZE, BUFSIZE, BUFSIZE,
+				      0, 0x3f63dfbf84af3b);
+		if (!w->fps || !w->rp)
+			return -1;
+	}
+	/* an io_uring for every worker, or reader threads for all */
+	for (i = 0; use_uring && i < nworkers; i++) {
+		if (uring_init(&pool.workers[i].ring, io_depth)) {
+			use_uring = 0;
+			while (--i >= 0)
+				uring_exit(&pool.workers[i].ring);
+		}
+	}
+	if (!use_uring && start_readers(nworkers * io_depth < 256 ?
+					nworkers * io_depth : 256))
+		return -1;
+	/* deques must all exist before anyone tries to steal */
+	for (i = 0; i < nworkers; i++)
+		if (pthread_create(&pool.workers[i].tid, NULL, worker_main,
+				   &pool.workers[i]))
+			return -1;
+	return 0;
+}
+
+static void finish_workers(void)
+{
+	int i, d;
+
+	pthread_mutex_lock(&pool.lock);
+	pool.done = 1;
+	pthread_cond_broadcast(&pool.wake);
+	pthread_mutex_unlock(&pool.lock);
+
+	for (i = 0; i < pool.nworkers; i++) {
+		pthread_join(pool.workers[i].tid, NULL);
+		for (d = 0; d < io_depth; d++)
+			rp_buffer_put(pool.workers[i].reqs[d].buf);
+		uring_exit(&pool.workers[i].ring);
+		free(pool.workers[i].fps);
+		rp_free(pool.workers[i].rp);
+		free(pool.workers[i].dq.items);
+	}
+	free(pool.files.items);
+	if (!use_uring)
+		stop_readers();
+}
+
+static int cmp_match(const void *a, const void *b)
+{
+	const struct match *ma = a, *mb = b;
+
+	if (ma->a != mb->a)
+		return ma->a < mb->a ? -1 : 1;
+	return ma->b < mb->b ? -1 : ma->b > mb->b;
+}
+
+/* print the candidate pairs all workers found, oldest chunk first */
+static void report_matches(void)
+{
+	struct match *all;
+	size_t n = 0, i;
+	int w;
+
+	for (w = 0; w < pool.nworkers; w++)
+		n += pool.workers[w].nmatches;
+	all = malloc((n ? n : 1) * sizeof(*all));
+	assert(all);
+	for (n = 0, w = 0; w < pool.nworkers; w++) {
+		memcpy(all + n, pool.workers[w].matches,
+		       pool.workers[w].nmatches * sizeof(*all));
+		n += pool.workers[w].nmatches;
+		free(pool.workers[w].matches);
+	}
+	qsort(all, n, sizeof(*all), cmp_match);
+
+	for (i = 0; i < n; i++) {
+		size_t a = all[i].a, b = all[i].b;
+
+		printf("Similar: %s at %lu and %s at %lu (%d of %d hashes)\n",
+		       arena.paths[sig_file(a)], *sig_at(a, SIG_OFF),
+		       arena.paths[sig_file(b)], *sig_at(b, SIG_OFF),
+		       all[i].shared, sketch_k);
+	}
+	printf("%zu candidate pairs sharing at least %d of %d hashes\n",
+	       n, match_k, sketch_k);
+	free(all);
+}
+
+/*
+ * The directory walker.  It works relative to directory fds, so no
+ * path is looked up more than one component at a time, and reads
+ * entries straight from getdents64() in large batches.  Each batch is
+ * sorted by inode number before anything in it is opened: on most
+ * filesystems inodes are allocated near their data, so this gets the
+ * files' metadata and (roughly) their blocks in disk order.
+ * Subdirectories are walked once their parent is done.  Regular files
+ * with more than one link are only hashed under the first name seen.
+ */
+
+#define DENTS_SIZE (64*1024)
+
+struct linux_dirent64 {
+	uint64_t d_ino;
+	int64_t d_off;
+	unsigned short d_reclen;
+	unsigned char d_type;
+	char d_name[];
+};
+
+/* (dev, ino) of the multiply linked files seen so far */
+static struct inode_key {
+	dev_t dev;
+	ino_t ino;
+} *seen;
+static size_t seen_size, seen_used;
+
+static int seen_before(dev_t dev, ino_t ino)
+{
+	size_t i, mask;
+
+	if (seen_used * 2 >= seen_size) {
+		struct inode_key *old = seen;
+		size_t old_size = seen_size;
+
+		seen_size = seen_size ? seen_size * 2 : 1024;
+		seen = calloc(seen_size, sizeof(*seen));
+		assert(seen);
+		seen_used = 0;
+		for (i = 0; i < old_size; i++)
+			if (old[i].ino)
+				seen_before(old[i].dev, old[i].ino);
+		free(old);
+	}
+
+	mask = seen_size - 1;
+	for (i = (ino * 0x9e3779b97f4a7c15ULL ^ dev) & mask; seen[i].ino;
+	     i = (i + 1) & mask)
+		if (seen[i].ino == ino && seen[i].dev == dev)
+			return 1;
+	seen[i].dev = dev;
+	seen[i].ino = ino;
+	seen_used++;
+	return 0;
+}
+
+static char *join_path(const char *dir, const char *name)
+{
+	size_t len = strlen(dir);
+	char *p = malloc(len + strlen(name) + 2);
+
+	assert(p);
+	memcpy(p, dir, len);
+	p[len] = '/';
+	strcpy(p + len + 1, name);
+	return p;
+}
+
+static int cmp_ino(const void *a, const void *b)
+{
+	const struct linux_dirent64 *da = *(struct linux_dirent64 * const *)a;
+	const struct linux_dirent64 *db = *(struct linux_dirent64 * const *)b;
+
+	return da->d_ino < db->d_ino ? -1 : da->d_ino > db->d_ino;
+}
+
+static int get_dirent_type(struct linux_dirent64 *entry, int dirfd,
+			   const char *dirpath)
 {
 	int ret;
 	struct stat st;
@@ -206,15 +1736,14 @@ static int get_dirent_type(struct dirent *entry, int fd)
 
 	/*
 	 * FS doesn't support file type in dirent, do this the old
-	 * fashioned way. We translate mode to DT_* for the
-	 * convenience of the caller.
+	 * fashioned way. We only care about files and directories.
 	 */
-	ret = fstatat(fd, entry->d_name, &st, AT_SYMLINK_NOFOLLOW);
+	ret = fstatat(dirfd, entry->d_name, &st, AT_SYMLINK_NOFOLLOW);
 	if (ret) {
 		fprintf(stderr,
 			"Error %d: %s while getting type of file %s/%s. "
 			"Skipping.\n",
-			errno, strerror(errno), path, entry->d_name);
+			errno, strerror(errno), dirpath, entry->d_name);
 		return DT_UNKNOWN;
 	}
 
@@ -222,145 +1751,221 @@ static int get_dirent_type(struct dirent *entry, int fd)
 		return DT_REG;
 	if (S_ISDIR(st.st_mode))
 		return DT_DIR;
-	if (S_ISBLK(st.st_mode))
-		return DT_BLK;
-	if (S_ISCHR(st.st_mode))
-		return DT_CHR;
-	if (S_ISFIFO(st.st_mode))
-		return DT_FIFO;
-	if (S_ISLNK(st.st_mode))
-		return DT_LNK;
-	if (S_ISSOCK(st.st_mode))
-		return DT_SOCK;
 
 	return DT_UNKNOWN;
 }
 
-int hash_file(char *filename)
+static void queue_file(int dirfd, const char *dirpath, const char *name)
 {
-	char abspath[PATH_MAX];
-	loff_t chunk_off = 0;
-	int ret = 0;
-	double elapsed;
-
-	if (realpath(filename, abspath) == NULL) {
-		printf("Error %d: %s while getting path to file %s\n",
-		       errno, strerror(errno), filename);
-	}
+	struct stat st;
+	uint32_t id;
+	int fd;
 
-	printf("Hashing file %s\n", abspath);
-	int fd = open(abspath, O_RDONLY);
+	fd = -1;
+	if (direct_io)
+		fd = openat(dirfd, name,
+			    O_RDONLY | O_NOFOLLOW | O_CLOEXEC | O_DIRECT);
+	/* not every filesystem does O_DIRECT */
+	if (fd < 0)
+		fd = openat(dirfd, name, O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
 	if (fd < 0) {
-		perror("Error opening file");
-		return 1;
+		fprintf(stderr, "Error %d: %s while opening %s/%s. Skipping.\n",
+			errno, strerror(errno), dirpath, name);
+		return;
 	}
+	/* it may have been replaced since we read the directory */
+	if (fstat(fd, &st) || !S_ISREG(st.st_mode) ||
+	    (st.st_nlink > 1 && seen_before(st.st_dev, st.st_ino))) {
+		close(fd);
+		return;
+	}
+	id = path_intern(dirpath, name);
+	db_record(id, &st);
+	hash_file(fd, st.st_size, id);
+}
+
+static void walk_fd(int dirfd, const char *dirpath)
+{
+	struct linux_dirent64 **batch = NULL;
+	char **subdirs = NULL;
+	size_t nsubdirs = 0, subdirs_size = 0, batch_size = 0;
+	char *buf = malloc(DENTS_SIZE);
+	long n;
+	size_t i;
 
-	//prep measurement
-	hash_elapsed = read_elapsed = 0;
+	assert(buf);
+	while ((n = syscall(SYS_getdents64, dirfd, buf, DENTS_SIZE)) > 0) {
+		size_t count = 0;
+		long off;
+
+		for (off = 0; off < n;
+		     off += ((struct linux_dirent64 *)(buf + off))->d_reclen) {
+			struct linux_dirent64 *entry = (void *)(buf + off);
+
+			if (strcmp(entry->d_name, ".") == 0
+			    || strcmp(entry->d_name, "..") == 0)
+				continue;
+			if (count == batch_size) {
+				batch_size = batch_size ? batch_size * 2 : 256;
+				batch = realloc(batch,
+						batch_size * sizeof(*batch));
+				assert(batch);
+			}
+			batch[count++] = entry;
+		}
+		qsort(batch, count, sizeof(*batch), cmp_ino);
 
-	overall_begin = clock();
-	while (!ret) {
-		ret = hash_chunk(fd, chunk_off, filename);
-		if (!ret)
-			chunk_off += CHUNK_SIZE;
+		for (i = 0; i < count; i++) {
+			switch (get_dirent_type(batch[i], dirfd, dirpath)) {
+			case DT_REG:
+				queue_file(dirfd, dirpath, batch[i]->d_name);
+				break;
+			case DT_DIR:
+				if (nsubdirs == subdirs_size) {
+					subdirs_size = subdirs_size ?
+						       subdirs_size * 2 : 16;
+					subdirs = realloc(subdirs, subdirs_size *
+							  sizeof(*subdirs));
+					assert(subdirs);
+				}
+				subdirs[nsubdirs] = strdup(batch[i]->d_name);
+				assert(subdirs[nsubdirs]);
+				nsubdirs++;
+				break;
+			}
+		}
 	}
-	overall_end = clock();
-	elapsed = (double)(overall_end - overall_begin) / CLOCKS_PER_SEC;
-	close(fd);
+	if (n < 0) {
+		fprintf(stderr, "Error %d: %s while reading directory %s\n",
+			errno, strerror(errno), dirpath);
+	}
+	free(batch);
+	free(buf);
 
-	printf("Hashed %lu mb in %f seconds(throughput: %f mb/s). Hash time: %f read time: %f\n",
-	       chunk_off / 1024 / 1024,
-	       elapsed, (chunk_off / elapsed)/1024/1024,
-	       (double)hash_elapsed/CLOCKS_PER_SEC, (double)read_elapsed/CLOCKS_PER_SEC);
+	for (i = 0; i < nsubdirs; i++) {
+		int fd = openat(dirfd, subdirs[i], O_RDONLY | O_DIRECTORY |
+				O_NOFOLLOW | O_CLOEXEC);
 
-	return 0;
-}
+		if (fd < 0) {
+			fprintf(stderr, "Error %d: %s while opening directory %s/%s\n",
+				errno, strerror(errno), dirpath, subdirs[i]);
+		} else {
+			char *path = join_path(dirpath, subdirs[i]);
 
+			walk_fd(fd, path);
+			free(path);
+			close(fd);
+		}
+		free(subdirs[i]);
+	}
+	free(subdirs);
+}
 
 static int walk_dir(const char *name)
 {
-	int ret = 0;
-	int type;
-	struct dirent *entry;
-	DIR *dirp;
 	char abspath[PATH_MAX];
+	int fd;
 
 	if (realpath(name, abspath) == NULL) {
 		printf("Error resolving initial dir\n");
+		snprintf(abspath, sizeof(abspath), "%s", name);
 	}
 
-	dirp = opendir(abspath);
-	if (dirp == NULL) {
+	fd = open(abspath, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	if (fd < 0) {
 		fprintf(stderr, "Error %d: %s while opening directory %s\n",
 			errno, strerror(errno), name);
 		return 0;
 	}
+	walk_fd(fd, abspath);
+	close(fd);
+	free(seen);
+	seen = NULL;
+	seen_size = seen_used = 0;
+	return 0;
+}
 
-	// global path no contains the TLD we are scanning from
-	ret = sprintf(pathp, "%s", name);
-	pathp += ret;
-
-	do {
-		errno = 0;
-		entry = readdir(dirp);
-		if (entry) {
-			if (strcmp(entry->d_name, ".") == 0
-			    || strcmp(entry->d_name, "..") == 0)
-				continue;
-
-			type = get_dirent_type(entry, dirfd(dirp));
-			if (type == DT_REG) {
-				//pathtmp now points to the root dir
-				char *pathtmp = pathp;
-
-				// adds a terminating null char
-				ret = sprintf(pathp, "/%s", entry->d_name);
-
-				if (hash_file(path)) {
-					ret = 1;
-					goto out;
-				}
+int main(int argc, char **argv)
+{
+	long nworkers = sysconf(_SC_NPROCESSORS_ONLN);
+	const char *db_path = NULL;
+	int ret, opt;
 
-				//pathp again points to rootdir, ready for
-				//next iter
-				pathp = pathtmp;
-			}
+	/*
+	 * -g: hash with the gear engine instead of rabin
+	 * -j: number of hashing threads, one per CPU by default
+	 * -k: report chunks sharing at least this many unit hashes
+	 * -s: unit hashes per chunk (SKETCH_MIN to SKETCH_MAX)
+	 * -b: sketch the smallest fingerprints instead of the largest
+	 * -d: signature database; unchanged files aren't hashed again
+	 * -q: chunk reads each worker keeps in flight
+	 * -D: read with O_DIRECT where possible
+	 * -P: read with pread() on reader threads, not io_uring
+	 */
+	while ((opt = getopt(argc, argv, "bd:gj:k:q:s:DP")) != -1) {
+		switch (opt) {
+		case 'g':
+			engine = RP_ENGINE_GEAR;
+			break;
+		case 'j':
+			nworkers = atoi(optarg);
+			break;
+		case 'k':
+			match_k = atoi(optarg);
+			break;
+		case 's':
+			sketch_k = atoi(optarg);
+			break;
+		case 'b':
+			sketch_bottom = 1;
+			break;
+		case 'd':
+			db_path = optarg;
+			break;
+		case 'q':
+			io_depth = atoi(optarg);
+			break;
+		case 'D':
+			direct_io = 1;
+			break;
+		case 'P':
+			use_uring = 0;
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-bgDP] [-j threads] [-q depth] [-s sketch] [-k shared] [-d db] dir\n",
+				argv[0]);
+			exit(1);
 		}
-	} while (entry != NULL);
-
-	if (errno) {
-		fprintf(stderr, "Error %d: %s while reading directory %s\n",
-			errno, strerror(errno), path);
+	}
+	if (optind >= argc || nworkers < 1 ||
+	    io_depth < 1 || io_depth > MAX_DEPTH ||
+	    sketch_k < SKETCH_MIN || sketch_k > SKETCH_MAX ||
+	    match_k < 1 || match_k > sketch_k) {
+		fprintf(stderr, "usage: %s [-bgDP] [-j threads] [-q depth] [-s sketch] [-k shared] [-d db] dir\n",
+			argv[0]);
+		exit(1);
 	}
 
-out:
-	closedir(dirp);
-	return ret;
-}
-
-int main(int arg, char **argv)
-{
-	int ret;
-
-	/* 1k chunks can be hashed, enough for testing */
-	hashes = calloc(5000, sizeof(struct chunk_hash));
-	if (hashes == NULL) {
-		printf("Error allocating memory");
+	if (db_path)
+		db_open(db_path);
+	index_init();
+	if (start_workers(nworkers)) {
+		printf("Error starting %ld workers\n", nworkers);
 		exit(1);
 	}
 
-	ret = walk_dir(argv[1]);
+	ret = walk_dir(argv[optind]);
+	finish_workers();
 	if (ret < 0) {
 		printf("Error hashing files in dir\n");
 		exit(1);
 	}
-#if 0
-	for (int i = 0; i < stor_index; i++) {
-		struct chunk_hash *chunk = &hashes[i];
-		printf("CHUNK[%d/%s]: id1: %lu id2: %lu id3: %lu  id4: %lu\n",
-		       i, chunk->filename, chunk->unit_hashes[0], chunk->unit_hashes[1],
-		       chunk->unit_hashes[2], chunk->unit_hashes[3]);
-	}
-#endif
+	report_matches();
+	if (db_path && db_save(db_path))
+		exit(1);
+	db_close();
+	index_free();
+	sig_free();
+	path_free();
 
 }
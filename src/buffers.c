@@ -0,0 +1,258 @@
+/*
+ * Copyright (C) 2026 The simdedup contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+ * USA
+ *
+ */
+
+/*
+ * Input buffers.
+ *
+ * A fresh multi-megabyte malloc() is mapped in 4 KiB pages that each
+ * fault in the first time the chunker writes them, and keep costing
+ * TLB misses after that; with a buffer per file or per chunk read
+ * that happens over and over.  So buffers of
+ * BUF_HUGE_SIZE and up are mapped in 2 MiB steps, backed by huge
+ * pages (reserved hugetlbfs ones if there are any, transparent ones
+ * otherwise), faulted in up front by the thread asking for them, and
+ * kept for reuse when they're given back.
+ *
+ * Faulting them in from the caller puts the pages on its NUMA node
+ * (Linux allocates on first touch), so the free buffers are kept per
+ * node and handed out to threads running there.  A RabinPoly's own
+ * input buffer comes from here too, but only once something is read
+ * into it: views and mapped files never need it, so they shouldn't
+ * pay for faulting it in.  rp_free() gives it back.  Smaller buffers
+ * aren't worth any of this and just come from posix_memalign().
+ * Everything is at least BUF_ALIGN aligned.
+ */
+
+#define _GNU_SOURCE
+
+#include "rabinpoly.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#define BUF_ALIGN 64			// a cache line
+#define BUF_HUGE_SIZE (2*1024*1024)	// a huge page
+#define BUF_PAGE_SIZE 4096
+/* free buffers kept per node; beyond this they're unmapped */
+#define BUF_CACHE_MAX (256*1024*1024)
+#define BUF_NODES 64
+
+struct buf {
+	void *mem;
+	size_t size;		    // mapped size, a multiple of BUF_HUGE_SIZE
+	int node;		    // where its pages are
+	int in_use;
+	struct buf *next;
+};
+
+static pthread_mutex_t bufs_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct buf *bufs;	    // every mapped buffer, in use or not
+static size_t bufs_free[BUF_NODES]; // bytes not in use, per node
+
+/* the NUMA node the calling thread is running on */
+static int buf_node(void) {
+	unsigned int cpu, node = 0;
+
+#ifdef SYS_getcpu
+	if (syscall(SYS_getcpu, &cpu, &node, NULL)) {
+		node = 0;
+	}
+#endif
+	return node % BUF_NODES;
+}
+
+static void *buf_map(size_t size) {
+	void *mem = MAP_FAILED;
+	size_t i;
+
+#ifdef MAP_HUGETLB
+	/* only succeeds if the admin has reserved huge pages */
+	mem = mmap(NULL, size, PROT_READ | PROT_WRITE,
+		   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+	if (mem == MAP_FAILED) {
+		/* map an extra huge page so we can trim to an aligned
+		 * start: transparent huge pages need one */
+		char *raw = mmap(NULL, size + BUF_HUGE_SIZE,
+				 PROT_READ | PROT_WRITE,
+				 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		size_t head;
+
+		if (raw == MAP_FAILED) {
+			return NULL;
+		}
+		head = (BUF_HUGE_SIZE - (uintptr_t)raw % BUF_HUGE_SIZE) %
+		       BUF_HUGE_SIZE;
+		if (head) {
+			munmap(raw, head);
+		}
+		munmap(raw + head + size, BUF_HUGE_SIZE - head);
+		mem = raw + head;
+#ifdef MADV_HUGEPAGE
+		madvise(mem, size, MADV_HUGEPAGE);
+#endif
+	}
+	/* fault it all in now, from here */
+	for (i = 0; i < size; i += BUF_PAGE_SIZE) {
+		((volatile char *)mem)[i] = 0;
+	}
+	return mem;
+}
+
+/*
+
+    rp_buffer_get() -- allocate an input buffer
+
+    Returns a buffer of at least 'size' bytes, aligned to 64 bytes,
+    to be given back with rp_buffer_put().  Large ones (2 MiB and up)
+    are huge page backed, already faulted in, and local to the calling
+    thread's NUMA node; they're recycled, so getting one that was put
+    back earlier costs next to nothing.  A RabinPoly takes its input
+    buffer from here the first time it reads into it; callers that
+    read into their own buffers can too.  Safe to call from any
+    thread.
+
+    Return values:
+    --------------
+
+    buf
+        The buffer
+
+    NULL
+        Out of memory, with errno set
+
+*/
+
+void *rp_buffer_get(size_t size) {
+	struct buf *b;
+	void *mem;
+	int node;
+
+	if (size < BUF_HUGE_SIZE) {
+		int rc = posix_memalign(&mem, BUF_ALIGN, size ? size : 1);
+
+		if (rc) {
+			errno = rc;
+			return NULL;
+		}
+		return mem;
+	}
+
+	size = (size + BUF_HUGE_SIZE - 1) / BUF_HUGE_SIZE * BUF_HUGE_SIZE;
+	node = buf_node();
+	pthread_mutex_lock(&bufs_lock);
+	for (b = bufs; b; b = b->next) {
+		if (!b->in_use && b->size == size && b->node == node) {
+			b->in_use = 1;
+			bufs_free[node] -= size;
+			pthread_mutex_unlock(&bufs_lock);
+			return b->mem;
+		}
+	}
+	pthread_mutex_unlock(&bufs_lock);
+
+	b = malloc(sizeof(*b));
+	if (!b) {
+		errno = ENOMEM;
+		return NULL;
+	}
+	b->mem = buf_map(size);
+	if (!b->mem) {
+		free(b);
+		errno = ENOMEM;
+		return NULL;
+	}
+	b->size = size;
+	b->node = node;
+	b->in_use = 1;
+	pthread_mutex_lock(&bufs_lock);
+	b->next = bufs;
+	bufs = b;
+	pthread_mutex_unlock(&bufs_lock);
+	return b->mem;
+}
+
+/*
+ * Give back a buffer from rp_buffer_get().  Large ones are kept for
+ * the next rp_buffer_get() on the same node, unless that node already
+ * has BUF_CACHE_MAX worth waiting.  NULL is fine.
+ */
+void rp_buffer_put(void *mem) {
+	struct buf **pb, *b;
+
+	if (!mem) {
+		return;
+	}
+	pthread_mutex_lock(&bufs_lock);
+	for (pb = &bufs; (b = *pb); pb = &b->next) {
+		if (b->mem != mem) {
+			continue;
+		}
+		if (bufs_free[b->node] + b->size <= BUF_CACHE_MAX) {
+			b->in_use = 0;
+			bufs_free[b->node] += b->size;
+			b = NULL;
+		} else {
+			*pb = b->next;
+		}
+		pthread_mutex_unlock(&bufs_lock);
+		if (b) {
+			munmap(b->mem, b->size);
+			free(b);
+		}
+		return;
+	}
+	pthread_mutex_unlock(&bufs_lock);
+	/* a small one */
+	free(mem);
+}
+
+/*
+ * Unmap every buffer that isn't in use, e.g. before going idle for a
+ * while.
+ */
+void rp_buffer_trim(void) {
+	struct buf **pb, *b, *unused = NULL;
+
+	pthread_mutex_lock(&bufs_lock);
+	for (pb = &bufs; (b = *pb);) {
+		if (b->in_use) {
+			pb = &b->next;
+			continue;
+		}
+		bufs_free[b->node] -= b->size;
+		*pb = b->next;
+		b->next = unused;
+		unused = b;
+	}
+	pthread_mutex_unlock(&bufs_lock);
+
+	while ((b = unused)) {
+		unused = b->next;
+		munmap(b->mem, b->size);
+		free(b);
+	}
+}
@@ -0,0 +1,249 @@
+/*
+ * Copyright (C) 2026 The simdedup contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+ * USA
+ *
+ */
+
+/*
+ * A block index for measuring (or doing) block-level dedup.
+ *
+ * Blocks are keyed by the first RP_DEDUP_KEY bytes of their digest,
+ * which are uniformly distributed already, so they double as the hash
+ * into an open-addressing table with linear probing.  The table is
+ * allocated once, at the size the caller can afford, and never grows:
+ * a store the size of a large volume has billions of blocks, and
+ * going over budget halfway through a scan helps nobody.  Once it's
+ * full, new blocks are still counted as unique but no longer
+ * remembered, and the stats say how many that was, so the answer is
+ * a lower bound on the savings rather than a failure.
+ */
+
+#include "rabinpoly.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+
+/* fill at most this many eighths of the table, to keep probes short */
+#define DEDUP_FILL 7
+
+struct rp_dedup {
+	enum rp_digest digest;	    // what the keys are made of
+	rp_dedup_entry *slots;	    // the table; refs == 0 means empty
+	size_t mask;		    // number of slots - 1
+	size_t used;		    // slots in use
+	size_t limit;		    // most slots we'll use
+	rp_dedup_stats total;	    // over everything added
+};
+
+/*
+
+    rp_dedup_new() -- create a block index
+
+    Args:
+    -----
+
+    digest
+
+        Which digest to key blocks by: RP_DIGEST_XXH3_128 or
+        RP_DIGEST_BLAKE3.  Only the first RP_DEDUP_KEY bytes are kept.
+
+    memory
+
+        How many bytes the table may take.  Each block takes
+        sizeof(rp_dedup_entry), and the table only fills up to 7/8.
+
+
+    Return values:
+    --------------
+
+    d
+        The index, to be freed with rp_dedup_free()
+
+    NULL
+        With errno set to EINVAL for a bad digest or too little
+        memory for even one block, or ENOMEM
+
+*/
+
+struct rp_dedup *rp_dedup_new(enum rp_digest digest, size_t memory) {
+	struct rp_dedup *d;
+	size_t slots = 1;
+
+	if (rp_digest_size(digest) < RP_DEDUP_KEY ||
+	    memory < 2 * sizeof(rp_dedup_entry)) {
+		errno = EINVAL;
+		return NULL;
+	}
+	while (slots <= memory / sizeof(rp_dedup_entry) / 2) {
+		slots *= 2;
+	}
+
+	d = calloc(1, sizeof(*d));
+	if (!d) {
+		errno = ENOMEM;
+		return NULL;
+	}
+	/* calloc() of this size gets fresh pages, so untouched slots
+	 * cost nothing */
+	d->slots = calloc(slots, sizeof(*d->slots));
+	if (!d->slots) {
+		free(d);
+		errno = ENOMEM;
+		return NULL;
+	}
+	d->digest = digest;
+	d->mask = slots - 1;
+	/* always leave an empty slot for lookups to stop at */
+	d->limit = slots / 8 * DEDUP_FILL;
+	if (!d->limit) {
+		d->limit = slots - 1;
+	}
+	return d;
+}
+
+void rp_dedup_free(struct rp_dedup *d) {
+	if (!d) {
+		return;
+	}
+	free(d->slots);
+	free(d);
+}
+
+/*
+ * The slot holding 'key', or the empty one where it would go.
+ */
+static rp_dedup_entry *dedup_slot(const struct rp_dedup *d,
+				  const unsigned char *key) {
+	u_int64_t h;
+	size_t i;
+
+	memcpy(&h, key, sizeof(h));
+	for (i = h & d->mask;; i = (i + 1) & d->mask) {
+		rp_dedup_entry *e = &d->slots[i];
+
+		if (!e->refs || !memcmp(e->key, key, RP_DEDUP_KEY)) {
+			return e;
+		}
+	}
+}
+
+/*
+
+    rp_dedup_add() -- count one block
+
+    Records a block with the given digest and length, first seen at
+    'offset' in input number 'file' (any numbering the caller likes),
+    and adds it to 'stats' if that's not NULL as well as to the
+    totals.
+
+    Returns 1 if the block was new, 0 if it had been seen before.  A
+    new block that didn't fit in the table any more is counted in
+    untracked_blocks too.
+
+*/
+
+int rp_dedup_add(struct rp_dedup *d, const unsigned char *digest,
+		 size_t length, u_int32_t file, u_int64_t offset,
+		 rp_dedup_stats *stats) {
+	rp_dedup_entry *e = dedup_slot(d, digest);
+	int is_new = !e->refs;
+
+	if (is_new) {
+		if (d->used < d->limit) {
+			memcpy(e->key, digest, RP_DEDUP_KEY);
+			e->offset = offset;
+			e->file = file;
+			e->length = length;
+			e->refs = 1;
+			d->used++;
+		} else {
+			d->total.untracked_blocks++;
+			if (stats) {
+				stats->untracked_blocks++;
+			}
+		}
+	} else {
+		e->refs++;
+	}
+
+	d->total.blocks++;
+	d->total.bytes += length;
+	d->total.unique_blocks += is_new;
+	d->total.unique_bytes += is_new ? length : 0;
+	if (stats) {
+		stats->blocks++;
+		stats->bytes += length;
+		stats->unique_blocks += is_new;
+		stats->unique_bytes += is_new ? length : 0;
+	}
+	return is_new;
+}
+
+/*
+
+    rp_dedup_scan() -- count every block of rp's input
+
+    Reads blocks from rp until its input runs out, adding each as
+    rp_dedup_add() does, with 'file' as the input number.  rp is
+    switched to the index's digest first.  'stats', if not NULL, is
+    cleared and then gets this input's numbers.
+
+    Returns 0 once the whole input is counted, or rp->error if reading
+    it failed (what was read up to there is still counted).
+
+*/
+
+int rp_dedup_scan(struct rp_dedup *d, RabinPoly *rp, u_int32_t file,
+		  rp_dedup_stats *stats) {
+	int rc;
+
+	if (stats) {
+		memset(stats, 0, sizeof(*stats));
+	}
+	if (rp->digest != d->digest) {
+		rp_set_digest(rp, d->digest);
+	}
+	while (!(rc = rp_block_next(rp))) {
+		rp_dedup_add(d, rp->block_digest, rp->block_size, file,
+			     rp->block_streampos, stats);
+	}
+	return rc == EOF ? 0 : rc;
+}
+
+/*
+
+    rp_dedup_lookup() -- find a block by digest
+
+    Returns the block's entry, or NULL if it hasn't been seen (or
+    didn't fit).  Entries never move, so the pointer stays good until
+    rp_dedup_free().
+
+*/
+
+const rp_dedup_entry *rp_dedup_lookup(const struct rp_dedup *d,
+				      const unsigned char *digest) {
+	const rp_dedup_entry *e = dedup_slot(d, digest);
+
+	return e->refs ? e : NULL;
+}
+
+/* totals over every block added so far */
+void rp_dedup_totals(const struct rp_dedup *d, rp_dedup_stats *stats) {
+	*stats = d->total;
+}
@@ -0,0 +1,491 @@
+/*
+ * Copyright (C) 2026 The simdedup contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+ * USA
+ *
+ */
+
+/*
+ * Strong per-block digests, so callers don't have to run every block
+ * through a separate hash library after chunking it.
+ *
+ * rp_block_next() digests each block right after finding its end,
+ * while the bytes it just scanned are still in cache.  Two kinds are
+ * offered: xxh3-128 from the bundled xxhash.h, which is plenty for
+ * dedup keys within a store, and BLAKE3 for content addresses that
+ * have to stand up to someone trying to make collisions.
+ *
+ * BLAKE3 is implemented here.  A block of more than one 1 KiB chunk
+ * is a tree of chunks, and all chunks but the last are hashed
+ * independently of each other, so on CPUs with AVX2 we compress eight
+ * of them at a time, one per vector element.  As in rolling.c,
+ * setting RABINPOLY_SIMD to "scalar" in the environment sticks to the
+ * portable code.
+ */
+
+#include "rabinpoly.h"
+#include "rp_internal.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+
+#define XXH_INLINE_ALL
+#include "xxhash.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HAVE_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+#define B3_BLOCK_LEN 64
+#define B3_CHUNK_LEN 1024
+
+/* chunks at a time passed to a chunk kernel */
+#define B3_MANY 8
+
+/* enough for 2^64 bytes of input */
+#define B3_MAX_DEPTH 54
+
+/* domain flags */
+#define B3_CHUNK_START	1
+#define B3_CHUNK_END	2
+#define B3_PARENT	4
+#define B3_ROOT		8
+
+static const u_int32_t b3_iv[8] = {
+	0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+	0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+};
+
+/* message word order for each of the seven rounds */
+static const unsigned char b3_schedule[7][16] = {
+	{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+	{2, 6, 3, 10, 7, 0, 4, 13, 1, 11, 12, 5, 9, 14, 15, 8},
+	{3, 4, 10, 12, 13, 2, 7, 14, 6, 5, 9, 0, 11, 15, 8, 1},
+	{10, 7, 12, 9, 14, 3, 13, 15, 4, 0, 11, 2, 5, 8, 1, 6},
+	{12, 13, 9, 11, 15, 10, 14, 8, 7, 2, 5, 3, 0, 1, 6, 4},
+	{9, 14, 11, 5, 8, 12, 15, 1, 13, 3, 0, 10, 2, 6, 4, 7},
+	{11, 15, 5, 0, 1, 9, 8, 6, 14, 10, 2, 12, 3, 4, 7, 13},
+};
+
+static inline u_int32_t load32(const unsigned char *p) {
+	return (u_int32_t)p[0] | (u_int32_t)p[1] << 8 |
+	       (u_int32_t)p[2] << 16 | (u_int32_t)p[3] << 24;
+}
+
+static inline void store32(unsigned char *p, u_int32_t w) {
+	p[0] = w;
+	p[1] = w >> 8;
+	p[2] = w >> 16;
+	p[3] = w >> 24;
+}
+
+static inline u_int32_t rotr32(u_int32_t w, int c) {
+	return (w >> c) | (w << (32 - c));
+}
+
+#define B3_G(v, a, b, c, d, x, y) do {				\
+	v[a] += v[b] + (x);					\
+	v[d] = rotr32(v[d] ^ v[a], 16);				\
+	v[c] += v[d];						\
+	v[b] = rotr32(v[b] ^ v[c], 12);				\
+	v[a] += v[b] + (y);					\
+	v[d] = rotr32(v[d] ^ v[a], 8);				\
+	v[c] += v[d];						\
+	v[b] = rotr32(v[b] ^ v[c], 7);				\
+} while (0)
+
+/*
+ * Compress one 64 byte block into the chaining value 'cv'.  The first
+ * eight output words are all we ever need: they're the next chaining
+ * value, and for the root node the 32 byte digest.
+ */
+static void b3_compress(u_int32_t cv[8], const unsigned char *block,
+			unsigned int len, u_int64_t counter,
+			unsigned int flags) {
+	u_int32_t m[16], v[16];
+	int i;
+
+	for (i = 0; i < 16; i++) {
+		m[i] = load32(block + 4 * i);
+	}
+	memcpy(v, cv, 8 * sizeof(*v));
+	memcpy(v + 8, b3_iv, 4 * sizeof(*v));
+	v[12] = counter;
+	v[13] = counter >> 32;
+	v[14] = len;
+	v[15] = flags;
+	for (i = 0; i < 7; i++) {
+		const unsigned char *s = b3_schedule[i];
+
+		B3_G(v, 0, 4, 8, 12, m[s[0]], m[s[1]]);
+		B3_G(v, 1, 5, 9, 13, m[s[2]], m[s[3]]);
+		B3_G(v, 2, 6, 10, 14, m[s[4]], m[s[5]]);
+		B3_G(v, 3, 7, 11, 15, m[s[6]], m[s[7]]);
+		B3_G(v, 0, 5, 10, 15, m[s[8]], m[s[9]]);
+		B3_G(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+		B3_G(v, 2, 7, 8, 13, m[s[12]], m[s[13]]);
+		B3_G(v, 3, 4, 9, 14, m[s[14]], m[s[15]]);
+	}
+	for (i = 0; i < 8; i++) {
+		cv[i] = v[i] ^ v[i + 8];
+	}
+}
+
+/*
+ * Chaining value of the chunk of 'len' bytes (at most B3_CHUNK_LEN)
+ * at 'src'.  'end_flags' go on its last block only.
+ */
+static void b3_chunk(const unsigned char *src, size_t len,
+		     u_int64_t counter, unsigned int end_flags,
+		     u_int32_t cv[8]) {
+	unsigned char block[B3_BLOCK_LEN];
+	unsigned int start = B3_CHUNK_START;
+
+	memcpy(cv, b3_iv, sizeof(b3_iv));
+	while (len > B3_BLOCK_LEN) {
+		b3_compress(cv, src, B3_BLOCK_LEN, counter, start);
+		start = 0;
+		src += B3_BLOCK_LEN;
+		len -= B3_BLOCK_LEN;
+	}
+	memset(block, 0, sizeof(block));
+	memcpy(block, src, len);
+	b3_compress(cv, block, len, counter,
+		    start | B3_CHUNK_END | end_flags);
+}
+
+/* combine two chaining values; 'out' may be either of them */
+static void b3_parent(const u_int32_t left[8], const u_int32_t right[8],
+		      unsigned int flags, u_int32_t out[8]) {
+	unsigned char block[B3_BLOCK_LEN];
+	int i;
+
+	for (i = 0; i < 8; i++) {
+		store32(block + 4 * i, left[i]);
+		store32(block + 32 + 4 * i, right[i]);
+	}
+	memcpy(out, b3_iv, sizeof(b3_iv));
+	b3_compress(out, block, B3_BLOCK_LEN, 0, B3_PARENT | flags);
+}
+
+/*
+ * A chunk kernel: the chaining values of 'n' (at most B3_MANY) whole
+ * chunks at 'src', the first of which is chunk number 'counter'.
+ */
+typedef void (*b3_chunks_fn)(const unsigned char *src, size_t n,
+			     u_int64_t counter, u_int32_t cvs[][8]);
+
+static void b3_chunks_scalar(const unsigned char *src, size_t n,
+			     u_int64_t counter, u_int32_t cvs[][8]) {
+	size_t i;
+
+	for (i = 0; i < n; i++) {
+		b3_chunk(src + i * B3_CHUNK_LEN, B3_CHUNK_LEN, counter + i, 0,
+			 cvs[i]);
+	}
+}
+
+#ifdef HAVE_X86_SIMD
+
+/*
+ * Eight chunks side by side: element i of every vector belongs to
+ * chunk i, so the state and the message words have to be transposed
+ * going in and out.
+ */
+
+__attribute__((target("avx2")))
+static inline __m256i b3_rot16(__m256i x) {
+	return _mm256_shuffle_epi8(x, _mm256_set_epi8(
+		13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2,
+		13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2));
+}
+
+__attribute__((target("avx2")))
+static inline __m256i b3_rot8(__m256i x) {
+	return _mm256_shuffle_epi8(x, _mm256_set_epi8(
+		12, 15, 14, 13, 8, 11, 10, 9, 4, 7, 6, 5, 0, 3, 2, 1,
+		12, 15, 14, 13, 8, 11, 10, 9, 4, 7, 6, 5, 0, 3, 2, 1));
+}
+
+#define B3_ROTR(x, c) \
+	_mm256_or_si256(_mm256_srli_epi32(x, c), _mm256_slli_epi32(x, 32 - (c)))
+
+#define B3_G8(v, a, b, c, d, x, y) do {				\
+	v[a] = _mm256_add_epi32(_mm256_add_epi32(v[a], v[b]), x);	\
+	v[d] = b3_rot16(_mm256_xor_si256(v[d], v[a]));		\
+	v[c] = _mm256_add_epi32(v[c], v[d]);			\
+	v[b] = B3_ROTR(_mm256_xor_si256(v[b], v[c]), 12);		\
+	v[a] = _mm256_add_epi32(_mm256_add_epi32(v[a], v[b]), y);	\
+	v[d] = b3_rot8(_mm256_xor_si256(v[d], v[a]));		\
+	v[c] = _mm256_add_epi32(v[c], v[d]);			\
+	v[b] = B3_ROTR(_mm256_xor_si256(v[b], v[c]), 7);		\
+} while (0)
+
+/* rows become columns: word j of v[i] ends up as word i of v[j] */
+__attribute__((target("avx2")))
+static inline void b3_transpose8(__m256i v[8]) {
+	__m256i ab_lo = _mm256_unpacklo_epi32(v[0], v[1]);
+	__m256i ab_hi = _mm256_unpackhi_epi32(v[0], v[1]);
+	__m256i cd_lo = _mm256_unpacklo_epi32(v[2], v[3]);
+	__m256i cd_hi = _mm256_unpackhi_epi32(v[2], v[3]);
+	__m256i ef_lo = _mm256_unpacklo_epi32(v[4], v[5]);
+	__m256i ef_hi = _mm256_unpackhi_epi32(v[4], v[5]);
+	__m256i gh_lo = _mm256_unpacklo_epi32(v[6], v[7]);
+	__m256i gh_hi = _mm256_unpackhi_epi32(v[6], v[7]);
+	__m256i abcd_04 = _mm256_unpacklo_epi64(ab_lo, cd_lo);
+	__m256i abcd_15 = _mm256_unpackhi_epi64(ab_lo, cd_lo);
+	__m256i abcd_26 = _mm256_unpacklo_epi64(ab_hi, cd_hi);
+	__m256i abcd_37 = _mm256_unpackhi_epi64(ab_hi, cd_hi);
+	__m256i efgh_04 = _mm256_unpacklo_epi64(ef_lo, gh_lo);
+	__m256i efgh_15 = _mm256_unpackhi_epi64(ef_lo, gh_lo);
+	__m256i efgh_26 = _mm256_unpacklo_epi64(ef_hi, gh_hi);
+	__m256i efgh_37 = _mm256_unpackhi_epi64(ef_hi, gh_hi);
+
+	v[0] = _mm256_permute2x128_si256(abcd_04, efgh_04, 0x20);
+	v[1] = _mm256_permute2x128_si256(abcd_15, efgh_15, 0x20);
+	v[2] = _mm256_permute2x128_si256(abcd_26, efgh_26, 0x20);
+	v[3] = _mm256_permute2x128_si256(abcd_37, efgh_37, 0x20);
+	v[4] = _mm256_permute2x128_si256(abcd_04, efgh_04, 0x31);
+	v[5] = _mm256_permute2x128_si256(abcd_15, efgh_15, 0x31);
+	v[6] = _mm256_permute2x128_si256(abcd_26, efgh_26, 0x31);
+	v[7] = _mm256_permute2x128_si256(abcd_37, efgh_37, 0x31);
+}
+
+__attribute__((target("avx2")))
+static void b3_chunks8_avx2(const unsigned char *src, u_int64_t counter,
+			    u_int32_t cvs[][8]) {
+	__m256i h[8], v[16], m[16], lo, hi;
+	u_int32_t c_lo[8], c_hi[8];
+	int i, b, r;
+
+	for (i = 0; i < 8; i++) {
+		c_lo[i] = counter + i;
+		c_hi[i] = (counter + i) >> 32;
+		h[i] = _mm256_set1_epi32(b3_iv[i]);
+	}
+	lo = _mm256_loadu_si256((const __m256i *)c_lo);
+	hi = _mm256_loadu_si256((const __m256i *)c_hi);
+
+	for (b = 0; b < B3_CHUNK_LEN / B3_BLOCK_LEN; b++) {
+		unsigned int flags = (b == 0 ? B3_CHUNK_START : 0) |
+			(b == B3_CHUNK_LEN / B3_BLOCK_LEN - 1 ? B3_CHUNK_END : 0);
+
+		for (i = 0; i < 8; i++) {
+			const unsigned char *p = src + i * B3_CHUNK_LEN +
+						 b * B3_BLOCK_LEN;
+
+			m[i] = _mm256_loadu_si256((const __m256i *)p);
+			m[i + 8] = _mm256_loadu_si256((const __m256i *)(p + 32));
+		}
+		b3_transpose8(m);
+		b3_transpose8(m + 8);
+
+		for (i = 0; i < 8; i++) {
+			v[i] = h[i];
+		}
+		for (i = 0; i < 4; i++) {
+			v[i + 8] = _mm256_set1_epi32(b3_iv[i]);
+		}
+		v[12] = lo;
+		v[13] = hi;
+		v[14] = _mm256_set1_epi32(B3_BLOCK_LEN);
+		v[15] = _mm256_set1_epi32(flags);
+		for (r = 0; r < 7; r++) {
+			const unsigned char *s = b3_schedule[r];
+
+			B3_G8(v, 0, 4, 8, 12, m[s[0]], m[s[1]]);
+			B3_G8(v, 1, 5, 9, 13, m[s[2]], m[s[3]]);
+			B3_G8(v, 2, 6, 10, 14, m[s[4]], m[s[5]]);
+			B3_G8(v, 3, 7, 11, 15, m[s[6]], m[s[7]]);
+			B3_G8(v, 0, 5, 10, 15, m[s[8]], m[s[9]]);
+			B3_G8(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+			B3_G8(v, 2, 7, 8, 13, m[s[12]], m[s[13]]);
+			B3_G8(v, 3, 4, 9, 14, m[s[14]], m[s[15]]);
+		}
+		for (i = 0; i < 8; i++) {
+			h[i] = _mm256_xor_si256(v[i], v[i + 8]);
+		}
+	}
+
+	b3_transpose8(h);
+	for (i = 0; i < 8; i++) {
+		_mm256_storeu_si256((__m256i *)cvs[i], h[i]);
+	}
+}
+
+__attribute__((target("avx2")))
+static void b3_chunks_avx2(const unsigned char *src, size_t n,
+			   u_int64_t counter, u_int32_t cvs[][8]) {
+	if (n == 8) {
+		b3_chunks8_avx2(src, counter, cvs);
+	} else {
+		b3_chunks_scalar(src, n, counter, cvs);
+	}
+}
+
+#endif /* HAVE_X86_SIMD */
+
+/*
+ * Pick the chunk kernel.  Unlike the rolling kernels there's nothing
+ * to calibrate: the AVX2 one does the same work in an eighth of the
+ * instructions.  Racing callers get the same answer.
+ */
+static b3_chunks_fn b3_pick(void) {
+	static b3_chunks_fn best;
+	b3_chunks_fn fn;
+	const char *want;
+
+	fn = __atomic_load_n(&best, __ATOMIC_ACQUIRE);
+	if (fn) {
+		return fn;
+	}
+	fn = b3_chunks_scalar;
+	want = getenv("RABINPOLY_SIMD");
+#ifdef HAVE_X86_SIMD
+	__builtin_cpu_init();
+	if ((!want || strcmp(want, "scalar")) &&
+	    __builtin_cpu_supports("avx2")) {
+		fn = b3_chunks_avx2;
+	}
+#else
+	(void)want;
+#endif
+	__atomic_store_n(&best, fn, __ATOMIC_RELEASE);
+	return fn;
+}
+
+/*
+ * BLAKE3 of 'len' bytes at 'src'.  All chunks but the last are pushed
+ * onto a stack of subtree chaining values, merging pairs as complete
+ * subtrees form; the last one is folded in with the root flag.
+ */
+static void blake3(const unsigned char *src, size_t len, unsigned char *out) {
+	u_int32_t stack[B3_MAX_DEPTH][8], cvs[B3_MANY][8], cv[8];
+	b3_chunks_fn chunks = b3_pick();
+	size_t whole = len ? (len - 1) / B3_CHUNK_LEN : 0;
+	size_t chunk = 0, depth = 0;
+	int i;
+
+	while (chunk < whole) {
+		size_t n = whole - chunk < B3_MANY ? whole - chunk : B3_MANY;
+		size_t j;
+
+		chunks(src + chunk * B3_CHUNK_LEN, n, chunk, cvs);
+		for (j = 0; j < n; j++) {
+			u_int64_t total = chunk + j + 1;
+
+			memcpy(cv, cvs[j], sizeof(cv));
+			while (!(total & 1)) {
+				b3_parent(stack[--depth], cv, 0, cv);
+				total >>= 1;
+			}
+			memcpy(stack[depth++], cv, sizeof(cv));
+		}
+		chunk += n;
+	}
+
+	b3_chunk(src + chunk * B3_CHUNK_LEN, len - chunk * B3_CHUNK_LEN,
+		 chunk, depth ? 0 : B3_ROOT, cv);
+	while (depth) {
+		depth--;
+		b3_parent(stack[depth], cv, depth ? 0 : B3_ROOT, cv);
+	}
+	for (i = 0; i < 8; i++) {
+		store32(out + 4 * i, cv[i]);
+	}
+}
+
+/*
+
+    rp_digest_size() -- how many bytes a digest of kind 'kind' takes
+
+    Returns 16 for RP_DIGEST_XXH3_128, 32 for RP_DIGEST_BLAKE3, and 0
+    for RP_DIGEST_NONE or anything unknown.
+
+*/
+
+size_t rp_digest_size(enum rp_digest kind) {
+	switch (kind) {
+	case RP_DIGEST_XXH3_128:
+		return 16;
+	case RP_DIGEST_BLAKE3:
+		return 32;
+	default:
+		return 0;
+	}
+}
+
+/*
+
+    rp_digest() -- digest 'size' bytes at 'src'
+
+    Writes rp_digest_size(kind) bytes to 'out': the same digest
+    rp_block_next() would put in block_digest for a block with these
+    contents.  xxh3-128 comes out in its canonical (big endian) byte
+    order, BLAKE3 as its usual 32 byte output.
+
+*/
+
+void rp_digest(enum rp_digest kind, const void *src, size_t size,
+	       unsigned char *out) {
+	switch (kind) {
+	case RP_DIGEST_XXH3_128:
+		XXH128_canonicalFromHash((XXH128_canonical_t *)out,
+					 XXH3_128bits(src, size));
+		break;
+	case RP_DIGEST_BLAKE3:
+		blake3(src, size, out);
+		break;
+	default:
+		break;
+	}
+}
+
+/*
+
+    rp_set_digest() -- have every block digested as it is found
+
+    From now on rp_block_next() (and so rp_find_boundaries()) leaves
+    the digest of each block in rp->block_digest, and
+    rp_find_boundaries_digest() can collect them in bulk.  The setting
+    survives rp_reset().  RP_DIGEST_NONE turns digests off again,
+    which is also how rp_new() leaves it.
+
+    Returns 0, or EINVAL for an unknown kind.
+
+*/
+
+int rp_set_digest(RabinPoly *rp, enum rp_digest kind) {
+	if (kind != RP_DIGEST_NONE && !rp_digest_size(kind)) {
+		return EINVAL;
+	}
+	rp->digest = kind;
+	memset(rp->block_digest, 0, sizeof(rp->block_digest));
+	if (kind == RP_DIGEST_BLAKE3) {
+		/* don't pay for picking a kernel on the first block */
+		b3_pick();
+	}
+	return 0;
+}
+
+/* digest the current block into rp->block_digest */
+void rp_digest_block(RabinPoly *rp) {
+	rp_digest(rp->digest, rp->block_addr, rp->block_size,
+		  rp->block_digest);
+}
@@ -0,0 +1,84 @@
+#!/usr/bin/python
+
+# Generate tables.h: the T[] and U[] tables calcT() would compute for
+# the polynomials and window sizes we use most, so that creating a
+# RabinPoly with one of them costs no table arithmetic at all.
+#
+#	src/mktables.py > src/tables.h
+
+from __future__ import print_function
+
+import sys
+
+BUILTIN = [
+	# (poly, window_size)
+	(0xbfe6b8a5bf378d83, 32),	# FINGERPRINT_PT, the LBFS one
+	(0x3f63dfbf84af3b, 32),		# examples/benchmark.c
+	(0x3f63dfbf84af3b, 512),	# simhash.c
+]
+
+MASK = (1 << 64) - 1
+
+def deg(p):
+	return p.bit_length() - 1
+
+def polymod(n, d):
+	k = deg(d)
+	while n and deg(n) >= k:
+		n ^= d << (deg(n) - k)
+	return n
+
+def polymult(x, y):
+	r = 0
+	while x:
+		if x & 1:
+			r ^= y
+		x >>= 1
+		y <<= 1
+	return r
+
+def polymmult(x, y, d):
+	return polymod(polymult(x, y), d)
+
+def tables(poly, window_size):
+	xshift = deg(poly)
+	shift = xshift - 8
+	t1 = polymod(1 << xshift, poly)
+	T = [(polymmult(i, t1, poly) | (i << xshift)) & MASK for i in range(256)]
+	sizeshift = 1
+	for i in range(1, window_size):
+		sizeshift = ((sizeshift << 8) & MASK) ^ T[sizeshift >> shift]
+	U = [polymmult(i, sizeshift, poly) for i in range(256)]
+	return shift, T, U
+
+def table(name, values):
+	out = ['\t\t.%s = {' % name]
+	for i in range(0, 256, 2):
+		out.append('\t\t\t0x%016xULL, 0x%016xULL,' % tuple(values[i:i+2]))
+	out.append('\t\t},')
+	return out
+
+out = [
+	'/* generated by mktables.py -- do not edit */',
+	'',
+	'struct builtin_tables {',
+	'\tu_int64_t poly;',
+	'\tunsigned int window_size;',
+	'\tint shift;',
+	'\tu_int64_t T[256];',
+	'\tu_int64_t U[256];',
+	'};',
+	'',
+	'static const struct builtin_tables builtin_tables[] = {',
+]
+for poly, window_size in BUILTIN:
+	shift, T, U = tables(poly, window_size)
+	out.append('\t{')
+	out.append('\t\t.poly = 0x%xULL,' % poly)
+	out.append('\t\t.window_size = %d,' % window_size)
+	out.append('\t\t.shift = %d,' % shift)
+	out += table('T', T)
+	out += table('U', U)
+	out.append('\t},')
+out.append('};')
+sys.stdout.write('\n'.join(out) + '\n')
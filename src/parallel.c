@@ -0,0 +1,362 @@
+/*
+ * Copyright (C) 2026 The simdedup contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+ * USA
+ *
+ */
+
+/*
+ * Chunking one input on several threads.
+ *
+ * Whether rp_block_next() cuts after a given byte depends on two
+ * things: the fingerprint there, and where the current block started.
+ * By the time a block is min_block_size long, a full window of its
+ * own bytes has been fed in (the skip in rp_block_next() stops
+ * window_size short of that), so every fingerprint that's ever tested
+ * is a function of the window_size bytes ending at that position and
+ * nothing else.  Only the second part is inherently sequential.
+ *
+ * So we work in rounds over a stretch of the input: each thread takes
+ * a segment and collects the positions whose fingerprint could end a
+ * block ("candidates"), using rp_fingerprint_matches(), which warms
+ * up on the bytes before the segment.  Then a single pass walks the
+ * candidates from the true start of the current block and applies the
+ * min/avg/max rules exactly as rp_block_next() does.  Cuts within
+ * max_block_size of the end of the stretch might depend on candidates
+ * past it, so those are left for the next round.
+ */
+
+#include "rabinpoly.h"
+#include "rp_internal.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+/* bytes each thread scans per round */
+#define SEGMENT_SIZE (4*1024*1024)
+
+/* initial room for candidates per segment, and the most we keep */
+#define MATCH_CHUNK 4096
+#define MAX_CANDIDATES (256*1024)
+
+#define MAX_THREADS 256
+
+struct segment {
+	const RabinPoly *rp;
+	const unsigned char *src;
+	size_t from, to;
+	u_int64_t mask;
+	rp_match *cand;		    // candidates found, in order
+	size_t ncand, size;
+	size_t scanned;		    // candidates before this are all in cand
+	int error;
+};
+
+/*
+ * Collect the candidates in one segment.  Pathological input (a long
+ * run of zeros, say) can make every position a candidate, so stop at
+ * MAX_CANDIDATES and let the merge know how far we got.
+ */
+static void *segment_scan(void *arg) {
+	struct segment *seg = arg;
+	size_t pos = seg->from;
+
+	seg->ncand = 0;
+	seg->error = 0;
+	while (pos < seg->to) {
+		size_t n, room;
+
+		if (seg->ncand == seg->size) {
+			size_t size = seg->size ? seg->size * 2 : MATCH_CHUNK;
+			rp_match *cand;
+
+			if (seg->size == MAX_CANDIDATES) {
+				break;
+			}
+			if (size > MAX_CANDIDATES) {
+				size = MAX_CANDIDATES;
+			}
+			cand = realloc(seg->cand, size * sizeof(*cand));
+			if (!cand) {
+				seg->error = ENOMEM;
+				break;
+			}
+			seg->cand = cand;
+			seg->size = size;
+		}
+		room = seg->size - seg->ncand;
+		errno = 0;
+		n = rp_fingerprint_matches(seg->rp, seg->src, pos, seg->to,
+					   seg->mask, seg->cand + seg->ncand,
+					   room);
+		if (!n && errno) {
+			seg->error = errno;
+			break;
+		}
+		seg->ncand += n;
+		if (n < room) {
+			pos = seg->to;
+			break;
+		}
+		pos = seg->cand[seg->ncand - 1].pos + 1;
+	}
+	seg->scanned = pos;
+	return NULL;
+}
+
+/*
+ * Leave rp as rp_block_next() would have after returning the block at
+ * 'offset', so serial calls can carry on from there.
+ */
+static void set_block(RabinPoly *rp, size_t offset, size_t length,
+		      u_int64_t fingerprint) {
+	const unsigned char *src = rp->inbuf;
+	size_t end = offset + length;
+	unsigned int i;
+
+	rp->block_streampos = offset;
+	rp->block_addr = rp->inbuf + offset;
+	rp->block_size = length;
+	rp->fingerprint = fingerprint;
+	if (rp->digest) {
+		rp_digest_block(rp);
+	}
+
+	/* both engines rebuild a short last block's fingerprint from
+	 * this, see rp_window_exact() */
+	for (i = 0; i < rp->window_size; i++) {
+		size_t pos = end - rp->window_size + i;
+		rp->window[i] = end >= rp->window_size - i ? src[pos] : 0;
+	}
+	rp->window_fed = 0;
+}
+
+/*
+
+    rp_find_boundaries_parallel() -- rp_find_boundaries() on several
+    threads
+
+    Finds exactly the blocks rp_find_boundaries() would, but computes
+    the fingerprints on up to 'nthreads' threads (0 means one per
+    online CPU).  It needs the whole input to be addressable, i.e. a
+    source set up with rp_from_view(), rp_from_buffer(), or
+    rp_from_file() on a file it could map; with a stream it simply
+    runs rp_find_boundaries().  Serial and parallel calls can be mixed
+    on the same input.
+
+    Work is done in rounds of up to 'nthreads' * 4 MiB, and a round
+    is only worth splitting if it's several MiB, so ask for plenty of
+    blocks at a time.
+
+    Block digests (see rp_set_digest()) aren't collected; only the
+    last block's ends up in block_digest.
+
+    Return values are as for rp_find_boundaries().  If memory runs
+    out, rp->error is set to ENOMEM.
+
+*/
+
+size_t rp_find_boundaries_parallel(RabinPoly *rp, rp_boundary *out,
+				   size_t max, int nthreads) {
+	struct segment seg[MAX_THREADS];
+	pthread_t tid[MAX_THREADS];
+	int started[MAX_THREADS];
+	const unsigned char *src = rp->inbuf;
+	size_t size = rp->inbuf_data_size;
+	size_t start = rp->block_streampos + rp->block_size;
+	size_t n = 0;
+	u_int64_t mask;
+	int i;
+
+	if (!rp->buffer_only) {
+		return rp_find_boundaries(rp, out, max);
+	}
+	if (rp->error || !max) {
+		return 0;
+	}
+
+	if (nthreads <= 0) {
+		long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+		nthreads = cpus > 0 ? cpus : 1;
+	}
+	if (nthreads > MAX_THREADS) {
+		nthreads = MAX_THREADS;
+	}
+
+	/*
+	 * Gear boundaries use the strict mask early in a block and the
+	 * loose one later; the loose one lets both through.
+	 */
+	mask = rp->engine == RP_ENGINE_GEAR ? rp->gear_mask_l
+					    : rp->fingerprint_mask;
+
+	/* settle the kernel choice before the threads race for it */
+	rp_fingerprints(rp, src, 0, 0, NULL);
+
+	memset(seg, 0, sizeof(seg));
+
+	while (n < max && start < size) {
+		size_t round = (size_t)nthreads * SEGMENT_SIZE;
+		size_t round_end, scanned, len, c = 0;
+		size_t found_before = n;
+		int nseg;
+
+		/* the blocks still wanted can't reach any further */
+		if ((max - n) < round / rp->max_block_size) {
+			round = (max - n) * rp->max_block_size;
+		}
+		if (round < rp->max_block_size) {
+			round = rp->max_block_size;
+		}
+		round_end = size - start > round ? start + round : size;
+
+		if (rp->map) {
+			size_t page = start & ~(size_t)(sysconf(_SC_PAGESIZE) - 1);
+
+			/* the threads won't read sequentially */
+			madvise(rp->map + page, round_end - page,
+				MADV_WILLNEED);
+		}
+
+		len = round_end - start;
+		nseg = len / nthreads < SEGMENT_SIZE / 4 ?
+		       (int)(len / (SEGMENT_SIZE / 4)) : nthreads;
+		if (nseg < 1) {
+			nseg = 1;
+		}
+		for (i = 0; i < nseg; i++) {
+			seg[i].rp = rp;
+			seg[i].src = src;
+			seg[i].mask = mask;
+			seg[i].from = start + len / nseg * i;
+			seg[i].to = i == nseg - 1 ? round_end
+						  : start + len / nseg * (i + 1);
+			started[i] = i > 0 && !pthread_create(&tid[i], NULL,
+							      segment_scan,
+							      &seg[i]);
+			if (i > 0 && !started[i]) {
+				segment_scan(&seg[i]);
+			}
+		}
+		segment_scan(&seg[0]);
+		for (i = 1; i < nseg; i++) {
+			if (started[i]) {
+				pthread_join(tid[i], NULL);
+			}
+		}
+		scanned = round_end;
+		for (i = nseg - 1; i >= 0; i--) {
+			if (seg[i].error) {
+				rp->error = seg[i].error;
+				goto out;
+			}
+			if (seg[i].scanned < seg[i].to) {
+				scanned = seg[i].scanned;
+			}
+		}
+
+		/* merge: the same decisions rp_block_next() makes */
+		i = 0;
+		while (n < max && start < size) {
+			size_t limit = size - start > rp->max_block_size ?
+				       start + rp->max_block_size : size;
+			size_t end = limit;
+			u_int64_t fp = 0;
+			int found = 0;
+
+			if (limit > scanned) {
+				break;
+			}
+			for (; i < nseg; i++, c = 0) {
+				for (; c < seg[i].ncand; c++) {
+					size_t e = seg[i].cand[c].pos + 1;
+
+					fp = seg[i].cand[c].fingerprint;
+					if (e <= start ||
+					    e - start < rp->min_block_size) {
+						continue;
+					}
+					if (e > limit) {
+						goto none;
+					}
+					if (rp->engine == RP_ENGINE_GEAR &&
+					    e - start < rp->avg_block_size &&
+					    (fp & rp->gear_mask_s)) {
+						continue;
+					}
+					end = e;
+					found = 1;
+					goto cut;
+				}
+			}
+		none:
+			/* a max_block_size block, or the end of the input */
+			rp_fingerprints(rp, src, end - 1, end, &fp);
+		cut:
+			out[n].offset = start;
+			out[n].length = end - start;
+			out[n].fingerprint = fp;
+			/* a content cut at max_block_size counts as a max
+			 * one, like in rp_block_scan() */
+			rp_count_block(rp, end - start, 0,
+				       end - start == rp->max_block_size ?
+				       &rp->stats.cuts_max : found ?
+				       &rp->stats.cuts_content :
+				       &rp->stats.cuts_end);
+			n++;
+			start = end;
+			if (found) {
+				c++;
+			}
+		}
+
+		if (n > found_before) {
+			set_block(rp, out[n - 1].offset, out[n - 1].length,
+				  out[n - 1].fingerprint);
+			if (rp->map && rp->block_streampos >= rp->map_next) {
+				rp_map_advise(rp);
+			}
+		} else {
+			/*
+			 * Too dense to get a whole max_block_size worth of
+			 * candidates: do one block the slow way.
+			 */
+			if (!rp_find_boundaries(rp, out + n, 1)) {
+				goto out;
+			}
+			n++;
+			start = rp->block_streampos + rp->block_size;
+		}
+	}
+
+	if (start == size && n < max) {
+		/* the input is used up, as rp_block_next() would find */
+		rp->block_streampos = size;
+		rp->block_addr = rp->inbuf + size;
+		rp->block_size = 0;
+		rp->error = EOF;
+	}
+out:
+	for (i = 0; i < MAX_THREADS; i++) {
+		free(seg[i].cand);
+	}
+	return n;
+}
@@ -24,11 +24,12 @@
 /*
  * To use this library:
  *
- * XXX
- *
- *      rp_init() to get started
- *      rp_in() in a loop to pass input chunks into rabin algorithm
- *      rp_out() in a loop to get output blocks from rabin algorithm
+ *      rp_new() (or rp_new_engine()) to get started
+ *      rp_from_file(), rp_from_stream(), rp_from_view(),
+ *      rp_from_buffer() or rp_from_source() to say where the input
+ *      comes from -- or rp_push() to hand it over as it arrives
+ *      rp_block_next() in a loop to get blocks one at a time, or
+ *      rp_find_boundaries() (rp_pull() for pushed input) for many
  *      rp_reset() to start a new input stream
  *      rp_free() to free memory when done
  *
@@ -37,15 +38,28 @@
  */
 
 #include "rabinpoly.h"
+#include "rp_internal.h"
+#include "tables.h"
 
 #include <assert.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <sys/types.h>
+#include <time.h>
+#include <unistd.h>
 
 static inline void rp_find_block_end(RabinPoly *rp);
+static void rp_source_close(RabinPoly *rp);
+static int rp_ownbuf_get(RabinPoly *rp);
+static size_t rp_stream_read(RabinPoly *rp, unsigned char *dst, size_t size);
+static size_t rp_source_read(RabinPoly *rp, unsigned char *dst, size_t size);
 
 /*
  * Routines for calculating the most significant bit of an integer.
@@ -98,6 +112,13 @@ static inline char fls64 (u_int64_t v)
 
 #define DEFAULT_WINDOW_SIZE 32
 
+/*
+ * How far apart (in stream bytes) rp_from_file() mappings get their
+ * madvise() hints refreshed: pages more than this far behind the
+ * current block are dropped, and this much is requested ahead of it.
+ */
+#define MAP_ADVISE_STEP (32*1024*1024)
+
 /* Fingerprint value take from LBFS fingerprint.h. For detail on this,
  * refer to the original rabin fingerprint paper.
  */
@@ -107,8 +128,35 @@ static u_int64_t polymod (u_int64_t nh, u_int64_t nl, u_int64_t d);
 static void polymult (u_int64_t *php, u_int64_t *plp, u_int64_t x, u_int64_t y);
 static u_int64_t polymmult (u_int64_t x, u_int64_t y, u_int64_t d);
 
-static void calcT(RabinPoly *rp);
-static u_int64_t slide8(RabinPoly *rp, unsigned char m);
+/*
+ * The lookup tables only depend on the engine, the polynomial and the
+ * window size, so RabinPolys with the same ones share a single,
+ * read-only copy.  Tables stay cached after their last user is freed,
+ * so creating a RabinPoly per input costs no more than a couple of
+ * mallocs; only the least recently used ones beyond TABLES_CACHE_MAX
+ * that nobody uses are dropped.
+ */
+
+#define TABLES_CACHE_MAX 16
+
+struct rp_tables {
+	struct rp_tables *next;	    // next most recently used
+	int refs;		    // RabinPolys using these tables
+	enum rp_engine engine;
+	u_int64_t poly;
+	unsigned int window_size;
+	int shift;
+	u_int64_t T[256];
+	u_int64_t U[256];
+};
+
+static pthread_mutex_t tables_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct rp_tables *tables_cache;
+static int tables_cached;
+
+static void calcT(struct rp_tables *t);
+static void calcG(struct rp_tables *t);
+static u_int64_t slide8(RabinPoly *rp, const unsigned char *p);
 static u_int64_t append8(RabinPoly *rp, u_int64_t p, unsigned char m);
 
 /*
@@ -160,56 +208,223 @@ static u_int64_t polymmult (u_int64_t x, u_int64_t y, u_int64_t d) {
 	return polymod (h, l, d);
 }
 
+/*
+ * Fill t[0..255] with polymmult(i, y, d) | (i << xshift), which is
+ * linear in i: only the eight powers of two need a (slow, bit by bit)
+ * multiplication, everything else is a sum of those.
+ */
+static void calc_linear(u_int64_t *t, u_int64_t y, u_int64_t d, int xshift) {
+	unsigned int i;
+
+	t[0] = 0;
+	for (i = 1; i < 256; i <<= 1) {
+		t[i] = polymmult (i, y, d);
+		if (xshift) {
+			t[i] |= (u_int64_t) i << xshift;
+		}
+	}
+	for (i = 3; i < 256; i++) {
+		if (i & (i - 1)) {
+			t[i] = t[i & (i - 1)] ^ t[i & -i];
+		}
+	}
+}
+
 /*
     Initialize the T[] and U[] array for faster computation of rabin
-    fingerprint.  Called only once from rp_init() during
-    initialization.
+    fingerprint.  Called from tables_get() the first time a
+    polynomial and window size are used.  The ones in tables.h just
+    get copied.
  */
 
-static void calcT(RabinPoly *rp) {
+static void calcT(struct rp_tables *t) {
+    const struct builtin_tables *b = NULL;
     unsigned int i;
-    int xshift = fls64 (rp->poly) - 1;
-    rp->shift = xshift - 8;
+    int xshift = fls64 (t->poly) - 1;
+    t->shift = xshift - 8;
+
+	for (i = 0; i < sizeof(builtin_tables) / sizeof(*b); i++) {
+		if (builtin_tables[i].poly == t->poly) {
+			b = &builtin_tables[i];
+			if (b->window_size == t->window_size) {
+				memcpy(t->T, b->T, sizeof(t->T));
+				memcpy(t->U, b->U, sizeof(t->U));
+				return;
+			}
+		}
+	}
 
-	u_int64_t T1 = polymod (0, INT64 (1) << xshift, rp->poly);
-	for (i = 0; i < 256; i++) {
-		rp->T[i] = polymmult (i, T1, rp->poly) | ((u_int64_t) i << xshift);
+	/* T[] only depends on the polynomial */
+	if (b) {
+		memcpy(t->T, b->T, sizeof(t->T));
+	} else {
+		u_int64_t T1 = polymod (0, INT64 (1) << xshift, t->poly);
+		calc_linear(t->T, T1, t->poly, xshift);
 	}
 
+	/* append8() with the T[] we just made */
 	u_int64_t sizeshift = 1;
-	for (i = 1; i < rp->window_size; i++) {
-		sizeshift = append8 (rp, sizeshift, 0);
+	for (i = 1; i < t->window_size; i++) {
+		sizeshift = (sizeshift << 8) ^ t->T[sizeshift >> t->shift];
 	}
 
-	for (i = 0; i < 256; i++) {
-		rp->U[i] = polymmult (i, sizeshift, rp->poly);
-		//printf("U[%u] = 0x%lx\n", i, rp->U[i]);
-	}
+	calc_linear(t->U, sizeshift, t->poly, 0);
 }
 
 /*
-   Feed a new byte into the rabin sliding window and update the rabin
-   fingerprint.
+   Feed the byte at p into the rabin sliding window and update the
+   rabin fingerprint.
+
+   The byte leaving the window is the one window_size bytes back.  The
+   input is contiguous, so that's usually still right there at
+   p - window_size; only for the first window_size bytes after a seam
+   (a skip, or the input moving, see rp_window_save()) does it come
+   from the copy of the window taken there.
  */
 
-static u_int64_t slide8(RabinPoly *rp, unsigned char m) {
-	rp->circbuf_pos++;
-	if (rp->circbuf_pos >= rp->window_size) {
-		rp->circbuf_pos = 0;
+static u_int64_t slide8(RabinPoly *rp, const unsigned char *p) {
+	unsigned char om;
+
+	if (rp->window_fed < rp->window_size) {
+		om = rp->window[rp->window_fed++];
+	} else {
+		om = p[-(long)rp->window_size];
 	}
-	unsigned char om = rp->circbuf[rp->circbuf_pos];
-	rp->circbuf[rp->circbuf_pos] = m;
-	return rp->fingerprint = append8 (rp, rp->fingerprint ^ rp->U[om], m);
+	return rp->fingerprint = append8 (rp, rp->fingerprint ^ rp->U[om], *p);
 }
 
 static u_int64_t append8(RabinPoly *rp, u_int64_t p, unsigned char m) {
 	return ((p << 8) | m) ^ rp->T[p >> rp->shift];
 }
 
+/*
+    Gear hashing (Xia et al., FastCDC, USENIX ATC '16): one shift and
+    one add per byte.  Each byte's contribution is shifted out after
+    64 more bytes, so the hash only ever depends on the last 64 bytes
+    -- an implicit window that needs no circular buffer.  The high
+    bits have seen the most bytes, so the boundary masks use those.
+
+    T[] holds the gear table; it's filled with splitmix64 output
+    seeded from the polynomial, so the same poly always yields the
+    same table (and hence the same boundaries).
+ */
+
+#define GEAR_WINDOW_SIZE 64
+
+static void calcG(struct rp_tables *t) {
+	unsigned int i;
+	u_int64_t x = t->poly;
+
+	for (i = 0; i < 256; i++) {
+		u_int64_t z = (x += 0x9e3779b97f4a7c15ULL);
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+		t->T[i] = z ^ (z >> 31);
+	}
+	t->shift = 0;
+}
+
+static inline u_int64_t gear8(RabinPoly *rp, unsigned char m) {
+	/* gear needs no window, but rp_window_save() keeps one anyway */
+	if (rp->window_fed < rp->window_size) {
+		rp->window_fed++;
+	}
+	return rp->fingerprint = (rp->fingerprint << 1) + rp->T[m];
+}
+
+/*
+ * Normalized chunking: below avg_block_size a boundary needs two more
+ * zero bits than the plain mask, from avg_block_size on two fewer.
+ * That pushes block sizes towards the average from both sides.  The
+ * masks are nested, so a position that satisfies the strict mask
+ * also satisfies the loose one.
+ */
+static u_int64_t gear_mask(int bits) {
+	if (bits <= 0) {
+		return 0;
+	}
+	if (bits > 63) {
+		bits = 63;
+	}
+	return ~(u_int64_t)0 << (64 - bits);
+}
+
+/*
+   Feed a byte into whichever engine rp uses.
+ */
+
+static inline u_int64_t roll8(RabinPoly *rp, const unsigned char *p) {
+	if (rp->engine == RP_ENGINE_GEAR) {
+		return gear8(rp, *p);
+	}
+	return slide8(rp, p);
+}
+
+/*
+   Find (or make) the tables for a configuration and take a reference
+   to them.  Returns NULL if out of memory.
+ */
+
+static struct rp_tables *tables_get(enum rp_engine engine, u_int64_t poly,
+				    unsigned int window_size) {
+	struct rp_tables **pt, *t, **unused = NULL;
+
+	pthread_mutex_lock(&tables_lock);
+	for (pt = &tables_cache; (t = *pt); pt = &t->next) {
+		if (t->engine == engine && t->poly == poly &&
+		    t->window_size == window_size) {
+			/* move to the front */
+			*pt = t->next;
+			goto found;
+		}
+	}
+
+	t = calloc(1, sizeof(*t));
+	if (!t) {
+		pthread_mutex_unlock(&tables_lock);
+		return NULL;
+	}
+	t->engine = engine;
+	t->poly = poly;
+	t->window_size = window_size;
+	if (engine == RP_ENGINE_GEAR) {
+		calcG(t);
+	} else {
+		calcT(t);
+	}
+
+	if (++tables_cached > TABLES_CACHE_MAX) {
+		for (pt = &tables_cache; *pt; pt = &(*pt)->next) {
+			if (!(*pt)->refs) {
+				unused = pt;
+			}
+		}
+		if (unused) {
+			struct rp_tables *old = *unused;
+			*unused = old->next;
+			free(old);
+			tables_cached--;
+		}
+	}
+
+found:
+	t->next = tables_cache;
+	tables_cache = t;
+	t->refs++;
+	pthread_mutex_unlock(&tables_lock);
+	return t;
+}
+
+static void tables_put(struct rp_tables *t) {
+	pthread_mutex_lock(&tables_lock);
+	t->refs--;
+	pthread_mutex_unlock(&tables_lock);
+}
+
 
 /*
 
-    rp_init() -- Initialize the RabinPoly structure
+    rp_new() -- Initialize the RabinPoly structure
 
     Call this first to create a state container to be passed to the
     other library functions.  You'll later need to free all of the
@@ -236,6 +451,17 @@ static u_int64_t append8(RabinPoly *rp, u_int64_t p, unsigned char m) {
 
         Maximum block size in bytes
 
+    inbuf_size
+
+        Size of the internal input buffer in bytes.  May be 0 if the
+        container will only ever be fed with rp_from_view(), which
+        scans caller memory in place.
+
+    poly
+
+        Irreducible polynomial to fingerprint with, e.g. the LBFS one,
+        0xbfe6b8a5bf378d83.
+
 
     Return values:
     --------------
@@ -251,7 +477,32 @@ static u_int64_t append8(RabinPoly *rp, u_int64_t p, unsigned char m) {
 RabinPoly* rp_new(unsigned int window_size, size_t avg_block_size,
 		  size_t min_block_size, size_t max_block_size,
 		  size_t inbuf_size, u_int64_t poly) {
+	return rp_new_engine(RP_ENGINE_RABIN, window_size, avg_block_size,
+			     min_block_size, max_block_size, inbuf_size, poly);
+}
+
+/*
+
+    rp_new_engine() -- rp_new() with a choice of boundary engine
+
+    RP_ENGINE_RABIN is what rp_new() gives you.  RP_ENGINE_GEAR finds
+    boundaries with a gear hash and normalized chunking instead: it's
+    considerably cheaper per byte and gives a tighter block size
+    distribution around avg_block_size, but of course different
+    boundaries.  Its window is fixed at 64 bytes, so window_size is
+    ignored, and poly only seeds the gear table.
+
+    Either way blocks come out of rp_block_next() the same way, and
+    calc_rabin() yields the engine's rolling hash at every byte.
+
+*/
+
+RabinPoly* rp_new_engine(enum rp_engine engine,
+			 unsigned int window_size, size_t avg_block_size,
+			 size_t min_block_size, size_t max_block_size,
+			 size_t inbuf_size, u_int64_t poly) {
 	RabinPoly *rp;
+	int bits;
 #if 0
 	if (!min_block_size || !avg_block_size || !max_block_size ||
 		(min_block_size > avg_block_size) ||
@@ -267,30 +518,57 @@ RabinPoly* rp_new(unsigned int window_size, size_t avg_block_size,
 		return NULL;
 	}
 
+	if (engine == RP_ENGINE_GEAR) {
+		window_size = GEAR_WINDOW_SIZE;
+	}
+
 	rp->poly = poly;
+	rp->engine = engine;
 	rp->window_size = window_size;
 	rp->inbuf_size = inbuf_size;
 	rp->avg_block_size = avg_block_size;
 	rp->min_block_size = min_block_size;
 	rp->max_block_size = max_block_size;
 	rp->fingerprint_mask = (1 << (fls32(rp->avg_block_size)-1))-1;
+	bits = fls32(rp->avg_block_size) - 1;
+	rp->gear_mask_s = gear_mask(bits + 2);
+	rp->gear_mask_l = gear_mask(bits > 2 ? bits - 2 : bits);
 
-	rp->circbuf = (unsigned char *)malloc(rp->window_size*sizeof(unsigned char));
-	if (!rp->circbuf){
-        free(rp);
+	rp->tables = tables_get(engine, poly, rp->window_size);
+	if (!rp->tables) {
+		free(rp);
 		return NULL;
 	}
+	rp->T = rp->tables->T;
+	rp->U = rp->tables->U;
+	rp->shift = rp->tables->shift;
 
-	rp->inbuf = (unsigned char *)malloc(rp->inbuf_size*sizeof(unsigned char));
-	if (!rp->inbuf){
-        free(rp->circbuf);
+	rp->window = (unsigned char *)malloc(rp->window_size*sizeof(unsigned char));
+	if (!rp->window){
+		tables_put(rp->tables);
         free(rp);
 		return NULL;
 	}
 
-    rp_from_stream(rp, NULL);
-
-    calcT(rp);
+	/* taken from the buffer pool once something is read into it, see
+	 * rp_ownbuf_get() */
+	rp->ownbuf = NULL;
+	rp->ownbuf_size = inbuf_size;
+
+	rp->stream = NULL;
+	rp->stream_owned = 0;
+	rp->map = NULL;
+	rp->map_size = 0;
+	rp->source = NULL;
+	rp->span = NULL;
+	rp->span_size = 0;
+	rp->span_pos = 0;
+	rp->func_stream_read = rp_stream_read;
+	rp->digest = RP_DIGEST_NONE;
+	memset(rp->block_digest, 0, sizeof(rp->block_digest));
+	rp_clear_stats(rp);
+
+    rp_reset(rp);
 
     return rp;
 }
@@ -300,30 +578,173 @@ void rp_free(RabinPoly *rp)
 	if (!rp) {
 		return;
 	}
-	free(rp->inbuf);
-	free(rp->circbuf);
+	rp_source_close(rp);
+	tables_put(rp->tables);
+	rp_buffer_put(rp->ownbuf);
+	free(rp->window);
 	free(rp);
 	rp = NULL;
 }
 
 void rp_from_buffer(RabinPoly *rp, unsigned char *src, size_t size) {
-	rp_from_stream(rp, NULL);
+	rp_reset(rp);
 	assert(size <= rp->inbuf_size);
+	if (rp_ownbuf_get(rp)) {
+		return;
+	}
 	memcpy(rp->inbuf, src, size);
 	rp->inbuf_data_size = size;
 	rp->buffer_only = 1;
 }
 
+/*
+ * Scan 'size' bytes of caller memory in place.  Unlike
+ * rp_from_buffer() nothing is copied and 'size' is not limited by
+ * inbuf_size: block_addr points straight into 'src', so the caller
+ * must keep it alive (and unmodified) for as long as blocks are being
+ * read from it.  The library never writes to 'src'.
+ */
+void rp_from_view(RabinPoly *rp, const void *src, size_t size) {
+	rp_reset(rp);
+	rp->inbuf = (unsigned char *)src;
+	rp->inbuf_size = size;
+	rp->inbuf_data_size = size;
+	rp->block_addr = rp->inbuf;
+	rp->buffer_only = 1;
+}
+
+/*
+ * Read from the file at 'path'.  Regular files are mmap'ed and scanned
+ * in place like a view, so there is neither a stdio copy nor a
+ * memmove of partial blocks; block_addr then stays valid until the
+ * next rp_from_*() or rp_free() call, which lets callers hang on to
+ * blocks after moving on.  Anything that can't be mapped (pipes,
+ * character devices, empty files) falls back to a stdio stream, with
+ * the usual rule that block_addr is only valid until the next
+ * rp_block_next().
+ *
+ * If the file can't be opened, rp->error is set to errno and the next
+ * rp_block_next() returns it.
+ */
 void rp_from_file(RabinPoly *rp, const char *path) {
-	FILE *stream = fopen(path, "rb");
+	struct stat st;
+	FILE *stream;
+	void *map;
+	int fd;
+
+	rp_reset(rp);
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		rp->error = errno;
+		return;
+	}
+
+	if (!fstat(fd, &st) && S_ISREG(st.st_mode) && st.st_size > 0 &&
+	    (uintmax_t)st.st_size <= SIZE_MAX) {
+		map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (map != MAP_FAILED) {
+			close(fd);
+			rp_from_view(rp, map, st.st_size);
+			rp->map = map;
+			rp->map_size = st.st_size;
+			madvise(rp->map, rp->map_size, MADV_SEQUENTIAL);
+			rp_map_advise(rp);
+			return;
+		}
+	}
+
+	stream = fdopen(fd, "rb");
 	if (!stream) {
 		rp->error = errno;
+		close(fd);
+		return;
 	}
-	rp_from_stream(rp, stream);
+	rp->stream = stream;
+	rp->stream_owned = 1;
+	rp->func_stream_read = rp_stream_read;
 }
 
-void rp_from_stream(RabinPoly *rp, FILE *stream) {
-	rp->stream = stream;
+/*
+ * Keep the kernel informed about where we are in a mapped file: ask
+ * for the next MAP_ADVISE_STEP bytes to be read ahead, and drop the
+ * pages well behind the current block so multi-GB files don't pin
+ * their whole size in memory.  Dropped pages of a read-only private
+ * mapping are simply faulted back in from the file if touched again,
+ * so earlier blocks remain valid.  Also used by parallel.c.
+ */
+void rp_map_advise(RabinPoly *rp) {
+	long pagesize = sysconf(_SC_PAGESIZE);
+	size_t pos = rp->block_streampos;
+	size_t len;
+
+	if (pos > MAP_ADVISE_STEP) {
+		size_t release = (pos - MAP_ADVISE_STEP) & ~(pagesize - 1);
+		if (release > rp->map_released) {
+			madvise(rp->map + rp->map_released,
+				release - rp->map_released, MADV_DONTNEED);
+			rp->map_released = release;
+		}
+	}
+
+	pos &= ~(pagesize - 1);
+	len = rp->map_size - pos;
+	if (len > 2 * MAP_ADVISE_STEP) {
+		len = 2 * MAP_ADVISE_STEP;
+	}
+	madvise(rp->map + pos, len, MADV_WILLNEED);
+
+	rp->map_next = rp->block_streampos + MAP_ADVISE_STEP;
+}
+
+/*
+ * Let go of whatever rp_from_file() opened, and of an rp_from_source()
+ * source.  Streams passed in by the caller to rp_from_stream() belong
+ * to the caller.
+ */
+static void rp_source_close(RabinPoly *rp) {
+	if (rp->source) {
+		if (rp->source->close) {
+			rp->source->close(rp->source_ctx);
+		}
+		rp->source = NULL;
+		rp->source_ctx = NULL;
+		rp->span = NULL;
+		rp->span_size = 0;
+		rp->span_pos = 0;
+		if (rp->func_stream_read == rp_source_read) {
+			rp->func_stream_read = rp_stream_read;
+		}
+	}
+	if (rp->map) {
+		munmap(rp->map, rp->map_size);
+		rp->map = NULL;
+		rp->map_size = 0;
+	}
+	if (rp->stream_owned) {
+		fclose(rp->stream);
+		rp->stream_owned = 0;
+	}
+	rp->stream = NULL;
+}
+
+/*
+
+    rp_reset() -- start over
+
+    Drops the current input (closing anything rp_from_file() opened)
+    and puts rp back the way rp_new() returned it, ready for the next
+    rp_from_*() call.  Nothing is freed or allocated, and the tables
+    are kept, so reusing a RabinPoly this way costs next to nothing.
+
+*/
+
+void rp_reset(RabinPoly *rp) {
+	rp_source_close(rp);
+	rp->map_released = 0;
+	rp->map_next = 0;
+	rp->inbuf = rp->ownbuf;
+	rp->inbuf_size = rp->ownbuf_size;
 	rp->error = 0;
 	rp->buffer_only = 0;
 	rp->inbuf_data_size = 0;
@@ -331,8 +752,145 @@ void rp_from_stream(RabinPoly *rp, FILE *stream) {
 	rp->block_streampos = 0;
 	rp->block_addr = rp->inbuf;
 	rp->fingerprint = 0;
-	rp->circbuf_pos = -1;
-	bzero ((char*) rp->circbuf, rp->window_size*sizeof (unsigned char));
+	rp->window_fed = 0;
+	bzero ((char*) rp->window, rp->window_size*sizeof (unsigned char));
+	rp->push_data = NULL;
+	rp->push_size = 0;
+	rp->push_eof = 0;
+	rp->block_resume = 0;
+}
+
+/*
+ * Read from 'stream' with fread().  With a NULL stream, input comes
+ * from whatever rp->func_stream_read the caller has set up instead.
+ */
+void rp_from_stream(RabinPoly *rp, FILE *stream) {
+	rp_reset(rp);
+	rp->stream = stream;
+	if (stream) {
+		rp->func_stream_read = rp_stream_read;
+	}
+}
+
+/*
+
+    rp_from_source() -- read from caller-supplied callbacks
+
+    Takes input from 'src' (see struct rp_source), passing 'ctx' to
+    each of its callbacks; src->close(), if set, is called once rp
+    moves on to other input or is freed.  'src' itself must outlive
+    that.
+
+    A source with a read() callback fills the internal input buffer
+    like a stream does, just without a FILE.  One with borrow() lends
+    spans of memory it already holds (a decompressor's output window,
+    a network buffer, ...), and blocks are found in place: block_addr
+    points into the span and nothing is copied, except for a block
+    that straddles two spans, which is put together in the input
+    buffer.  That needs an input buffer of at least max_block_size.
+    Either way block_addr is valid until the next rp_block_next().
+
+    If the source can't be used, rp->error is set to EINVAL and the
+    next rp_block_next() returns it.
+
+*/
+
+void rp_from_source(RabinPoly *rp, const rp_source *src, void *ctx) {
+	rp_reset(rp);
+	rp->source = src;
+	rp->source_ctx = ctx;
+	if (src->borrow ? rp->ownbuf_size < rp->max_block_size :
+	    !src->read || !rp->ownbuf_size) {
+		rp->error = EINVAL;
+		return;
+	}
+	if (!src->borrow) {
+		rp->func_stream_read = rp_source_read;
+	}
+}
+
+/* lends rp_push()'s packets to the borrow machinery, one at a time */
+static const unsigned char *rp_push_borrow(void *ctx, size_t *size,
+					   int *error) {
+	RabinPoly *rp = ctx;
+	const unsigned char *data = rp->push_data;
+
+	if (!data) {
+		*error = rp->push_eof ? EOF : EAGAIN;
+		return NULL;
+	}
+	*size = rp->push_size;
+	rp->push_data = NULL;
+	return data;
+}
+
+static const rp_source rp_push_source = { NULL, rp_push_borrow, NULL };
+
+/*
+
+    rp_push() -- hand rp the next piece of its input
+
+    For input that arrives rather than being read, such as a network
+    connection with a RabinPoly per client: push each packet as it
+    comes in, then collect what it completes with rp_pull() (or
+    rp_block_next()) until that reports EAGAIN.  The packet has been
+    used up then, and the block in progress goes on with the next
+    one.  Push size 0 (data may be NULL) at the end of the input; the
+    last block then comes out, and after it EOF.
+
+    The first push after rp_new() or any other input starts a new
+    stream, and so does one after rp_reset().  Blocks are found in
+    place in the packet; a block that spans packets is put together
+    in the input buffer, so rp needs one of max_block_size bytes, but
+    no more however long the stream or the packets.  That's all the
+    memory a stream takes besides the RabinPoly itself.
+
+    Args:
+    -----
+
+    data, size
+
+        The packet.  It must stay put until rp_pull() reports EAGAIN;
+        nothing in it is referred to after that.
+
+
+    Return values:
+    --------------
+
+    0
+        Taken
+
+    EBUSY
+        The previous packet hasn't been taken in yet: pull first
+
+    EINVAL
+        The input buffer is smaller than max_block_size
+
+    EOF, or an errno value
+        The stream has ended; rp_reset() to start another
+
+*/
+
+int rp_push(RabinPoly *rp, const void *data, size_t size) {
+	if (rp->source != &rp_push_source) {
+		rp_from_source(rp, &rp_push_source, rp);
+	}
+	if (rp->error && rp->error != EAGAIN) {
+		return rp->error;
+	}
+	if (rp->push_data) {
+		return EBUSY;
+	}
+	if (size) {
+		rp->push_data = data;
+		rp->push_size = size;
+	} else {
+		rp->push_eof = 1;
+	}
+	if (rp->error == EAGAIN) {
+		rp->error = 0;
+	}
+	return 0;
 }
 
 static size_t rp_stream_read(RabinPoly *rp, unsigned char *dst, size_t size) {
@@ -348,21 +906,241 @@ static size_t rp_stream_read(RabinPoly *rp, unsigned char *dst, size_t size) {
 	return count;
 }
 
+static size_t rp_source_read(RabinPoly *rp, unsigned char *dst, size_t size) {
+	int error = 0;
+	size_t count = rp->source->read(rp->source_ctx, dst, size, &error);
+
+	rp->error = 0;
+	if (count == 0) {
+		rp->error = error ? error : EOF;
+	}
+	return count;
+}
+
 #define CUR_ADDR rp->block_addr+rp->block_size
 #define INBUF_END rp->inbuf+rp->inbuf_size
 
+/*
+ * Called at a seam: the bytes right before CUR_ADDR are about to stop
+ * being the ones last hashed, because we skip ahead or the input is
+ * moved or switched to another buffer.  Keep a copy of the window for
+ * slide8() and friends to take leaving bytes from until window_size
+ * new ones have gone by.  The bytes hashed since the last seam must
+ * still be in place.
+ */
+static void rp_window_save(RabinPoly *rp) {
+	size_t w = rp->window_size, fed = rp->window_fed;
+	const unsigned char *cur = CUR_ADDR;
+
+	if (fed >= w) {
+		memcpy(rp->window, cur - w, w);
+	} else if (fed) {
+		memmove(rp->window, rp->window + fed, w - fed);
+		memcpy(rp->window + w - fed, cur - fed, fed);
+	}
+	rp->window_fed = 0;
+}
+
+/*
+ * Make sure ownbuf is there before anything is put in it.  rp_new()
+ * doesn't allocate it, since views and mapped files never use it, and
+ * rp_buffer_get() faults large buffers in right away; this gets it
+ * on first use instead, from the thread doing the reading.  Returns
+ * 0, or ENOMEM with rp->error set.
+ */
+static int rp_ownbuf_get(RabinPoly *rp) {
+	if (rp->ownbuf || !rp->ownbuf_size) {
+		return 0;
+	}
+	rp->ownbuf = rp_buffer_get(rp->ownbuf_size);
+	if (!rp->ownbuf) {
+		rp->error = ENOMEM;
+		return ENOMEM;
+	}
+	if (!rp->inbuf) {
+		/* nothing read yet: start out in it */
+		rp->inbuf = rp->ownbuf;
+		rp->block_addr = rp->inbuf;
+	}
+	return 0;
+}
+
+/*
+ * Borrowed input.  The current block is scanned right in the span
+ * when it fits there; when it runs off the end, what there is of it
+ * goes to the start of ownbuf and the rest is copied in from the
+ * following span(s) as needed.  The block that ends up finishing it
+ * ends in the latest span, so the next one starts there, and
+ * rp_borrow_resume() moves back to scanning in place.  span_pos counts
+ * the bytes of the span that have been taken into the input, in place
+ * or copied.
+ */
+static void rp_borrow_resume(RabinPoly *rp) {
+	size_t left;
+
+	if (!rp->span || rp->inbuf != rp->ownbuf) {
+		return;
+	}
+	rp_window_save(rp);
+	/* copied bytes not used yet, all from the current span */
+	left = rp->inbuf + rp->inbuf_data_size - rp->block_addr;
+	assert(left <= rp->span_pos);
+	rp->inbuf = (unsigned char *)rp->span;
+	rp->inbuf_size = rp->span_size;
+	rp->inbuf_data_size = rp->span_size;
+	rp->block_addr = rp->inbuf + rp->span_pos - left;
+	rp->span_pos = rp->span_size;
+}
+
+static size_t rp_borrow_more(RabinPoly *rp) {
+	size_t have = rp->block_size;
+	size_t count;
+	int error = 0;
+
+	rp_window_save(rp);
+	if (rp->inbuf != rp->ownbuf && have) {
+		/* the block runs off the end of the span: carry it over */
+		if (rp_ownbuf_get(rp)) {
+			return 0;
+		}
+		memcpy(rp->ownbuf, rp->block_addr, have);
+		rp->stats.bytes_moved += have;
+		rp->inbuf = rp->ownbuf;
+		rp->inbuf_size = rp->ownbuf_size;
+		rp->inbuf_data_size = have;
+		rp->block_addr = rp->inbuf;
+	} else if (rp->inbuf == rp->ownbuf && CUR_ADDR == INBUF_END) {
+		memmove(rp->inbuf, rp->block_addr, have);
+		rp->stats.bytes_moved += have;
+		rp->block_addr = rp->inbuf;
+		rp->inbuf_data_size = have;
+	}
+
+	if (rp->span_pos == rp->span_size) {
+		rp->span = rp->source->borrow(rp->source_ctx, &count, &error);
+		rp->span_pos = 0;
+		rp->span_size = rp->span ? count : 0;
+		if (!rp->span_size) {
+			rp->error = error ? error : EOF;
+			return 0;
+		}
+		if (!have) {
+			/* nothing to carry over: straight to the span */
+			rp->inbuf = (unsigned char *)rp->span;
+			rp->inbuf_size = rp->span_size;
+			rp->inbuf_data_size = rp->span_size;
+			rp->block_addr = rp->inbuf;
+			rp->span_pos = rp->span_size;
+			return rp->span_size;
+		}
+	}
+
+	count = rp->span_size - rp->span_pos;
+	if (count > rp->inbuf_size - rp->inbuf_data_size) {
+		count = rp->inbuf_size - rp->inbuf_data_size;
+	}
+	memcpy(rp->inbuf + rp->inbuf_data_size, rp->span + rp->span_pos, count);
+	rp->span_pos += count;
+	rp->inbuf_data_size += count;
+	return count;
+}
+
+/* histogram bucket for 'v', see struct rp_stats */
+static inline int stats_bucket(u_int64_t v) {
+	int b = fls64 (v) - 1;
+
+	if (b < 0) {
+		return 0;
+	}
+	return b < RP_STATS_BUCKETS ? b : RP_STATS_BUCKETS - 1;
+}
+
+static inline u_int64_t now_ns(void) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/*
+ * Account for a block of 'length' bytes, the first 'skipped' of which
+ * were never hashed, that ended the way 'cut' (one of the stats.cuts_*
+ * counters) says.  Also used by parallel.c.
+ */
+void rp_count_block(RabinPoly *rp, size_t length, size_t skipped,
+		    u_int64_t *cut) {
+	rp->stats.blocks++;
+	(*cut)++;
+	rp->stats.bytes_scanned += length - skipped;
+	rp->stats.bytes_skipped += skipped;
+	rp->stats.block_sizes[stats_bucket(length)]++;
+}
+
+/*
+ * Get more input once the current block has reached the end of the
+ * data.  Returns the number of bytes added; if none, rp->error says
+ * why.
+ */
+static size_t rp_refill(RabinPoly *rp) {
+	size_t size, count;
+	u_int64_t begin, ns;
+
+	if (rp->buffer_only) {
+		/* don't refill buffer */
+		rp->error = EOF;
+		return 0;
+	}
+	begin = now_ns();
+	if (rp->source && rp->source->borrow) {
+		count = rp_borrow_more(rp);
+	} else {
+		/* use func_stream_read to refill buffer */
+		if (rp_ownbuf_get(rp)) {
+			return 0;
+		}
+		size = rp->inbuf_size - rp->inbuf_data_size;
+		assert(size > 0);
+		count = rp->func_stream_read(rp, rp->inbuf + rp->inbuf_data_size,
+					     size);
+		if (!count) {
+			assert(rp->error);
+		}
+		rp->inbuf_data_size += count;
+	}
+	ns = now_ns() - begin;
+
+	rp->stats.refills++;
+	rp->stats.bytes_read += count;
+	rp->stats.read_ns += ns;
+	if (ns > rp->stats.read_ns_max) {
+		rp->stats.read_ns_max = ns;
+	}
+	rp->stats.read_times[stats_bucket(ns)]++;
+	return count;
+}
+
 int calc_rabin(RabinPoly *rp)
 {
     rp->block_streampos += rp->block_size;
     rp->block_addr += rp->block_size;
     rp->block_size = 0;
 
-    if (CUR_ADDR == INBUF_END) {
+    if (rp->map && rp->block_streampos >= rp->map_next) {
+	    rp_map_advise(rp);
+    }
+    if (rp->span) {
+	    rp_borrow_resume(rp);
+    }
+
+    if (CUR_ADDR == INBUF_END && !rp->buffer_only &&
+        rp->inbuf == rp->ownbuf && !rp->span) {
 	    /* end of input buffer: there's a partial block at the end
 	     * of the buffer; move it to the beginning of the buffer
 	     * so we can append more from input stream
 	     */
+	    rp_window_save(rp);
 	    memmove(rp->inbuf, rp->block_addr, rp->block_size);
+	    rp->stats.bytes_moved += rp->block_size;
 	    rp->block_addr = rp->inbuf;
 	    rp->inbuf_data_size = rp->block_size;
     }
@@ -371,20 +1149,7 @@ int calc_rabin(RabinPoly *rp)
 	    /* no more valid data in input buffer */
 	    int count = 0;
 	    if (!rp->error) {
-		    if (rp->buffer_only) {
-			    /* don't refill buffer */
-			    rp->error = EOF;
-		    } else {
-			    /* use func_stream_read to refill buffer */
-			    int size = rp->inbuf_size - rp->inbuf_data_size;
-			    assert(size > 0);
-			    count = rp_stream_read(rp,
-						   rp->inbuf + rp->inbuf_data_size, size);
-			    if (!count) {
-				    assert(rp->error);
-			    }
-			    rp->inbuf_data_size += count;
-		    }
+		    count = rp_refill(rp);
 	    }
 	    if (rp->error && (count == 0)) {
 		    /* we're either carrying an error from earlier, or the
@@ -403,18 +1168,159 @@ int calc_rabin(RabinPoly *rp)
     }
 
     /* feed the next byte into rabinpoly algo */
-    slide8(rp, rp->block_addr[rp->block_size]);
+    roll8(rp, CUR_ADDR);
     rp->block_size++;
 
     return 0;
 }
 
-int rp_block_next(RabinPoly *rp) {
+/*
+ * The input ended in a block that skipped bytes before the window
+ * had caught up with them: make the fingerprint (and window) what
+ * hashing every byte would have left, by hashing the last window_size
+ * bytes from scratch.  Those are all in the block, or if it's shorter
+ * than the window, its bytes plus what's left of the window saved at
+ * its start, which nothing has been hashed out of yet.
+ */
+static void rp_window_exact(RabinPoly *rp) {
+	u_int64_t fp = 0;
+	size_t i;
+
+	rp->window_fed = rp->block_size < rp->window_size ?
+			 rp->block_size : rp->window_size;
+	rp_window_save(rp);
+	for (i = 0; i < rp->window_size; i++) {
+		if (rp->engine == RP_ENGINE_GEAR) {
+			fp = (fp << 1) + rp->T[rp->window[i]];
+		} else {
+			fp = append8(rp, fp, rp->window[i]);
+		}
+	}
+	rp->fingerprint = fp;
+}
+
+/*
+ * The inner loops of rp_block_scan().  Each feeds the n bytes at p into
+ * the rolling hash with the fingerprint, table pointers and window
+ * position in locals, and if 'test' is set stops right after a byte
+ * that leaves none of 'mask' set in the fingerprint.  Returns how many
+ * bytes it fed.  The caller guarantees that all n bytes are in the
+ * buffer and that none of them takes the block past min_block_size
+ * (untested), avg_block_size (gear's mask changes) or max_block_size,
+ * so nothing else needs checking per byte.
+ *
+ * The window size is a parameter so that scan_rabin_span() can have
+ * the common ones compiled in as constants, which makes the load of
+ * the byte leaving the window a fixed offset from the one coming in.
+ */
+static inline __attribute__((always_inline))
+size_t scan_rabin(RabinPoly *rp, const unsigned char *p, size_t n,
+		  u_int64_t mask, int test, unsigned int window_size) {
+	const u_int64_t *T = rp->T, *U = rp->U;
+	u_int64_t fp = rp->fingerprint;
+	int shift = rp->shift;
+	size_t i = 0;
+
+	/* just past a seam: the leaving bytes are in rp->window */
+	while (rp->window_fed < window_size && i < n) {
+		unsigned char m = p[i++];
+
+		fp ^= U[rp->window[rp->window_fed++]];
+		fp = ((fp << 8) | m) ^ T[fp >> shift];
+		if (test && (fp & mask) == 0) {
+			goto out;
+		}
+	}
+	while (i < n) {
+		unsigned char m = p[i];
+
+		fp ^= U[p[i - window_size]];
+		fp = ((fp << 8) | m) ^ T[fp >> shift];
+		i++;
+		if (test && (fp & mask) == 0) {
+			break;
+		}
+	}
+out:
+	rp->fingerprint = fp;
+	return i;
+}
+
+#define SCAN_RABIN(w)							\
+static size_t scan_rabin_##w(RabinPoly *rp, const unsigned char *p,	\
+			     size_t n, u_int64_t mask, int test) {	\
+	return test ? scan_rabin(rp, p, n, mask, 1, w) :		\
+		      scan_rabin(rp, p, n, mask, 0, w);			\
+}
+
+SCAN_RABIN(32)
+SCAN_RABIN(48)
+SCAN_RABIN(64)
+SCAN_RABIN(512)
+
+static size_t scan_rabin_span(RabinPoly *rp, const unsigned char *p,
+			      size_t n, u_int64_t mask, int test) {
+	switch (rp->window_size) {
+	case 32:
+		return scan_rabin_32(rp, p, n, mask, test);
+	case 48:
+		return scan_rabin_48(rp, p, n, mask, test);
+	case 64:
+		return scan_rabin_64(rp, p, n, mask, test);
+	case 512:
+		return scan_rabin_512(rp, p, n, mask, test);
+	}
+	return test ? scan_rabin(rp, p, n, mask, 1, rp->window_size) :
+		      scan_rabin(rp, p, n, mask, 0, rp->window_size);
+}
+
+static size_t scan_gear_span(RabinPoly *rp, const unsigned char *p,
+			     size_t n, u_int64_t mask, int test) {
+	const u_int64_t *T = rp->T;
+	u_int64_t fp = rp->fingerprint;
+	size_t i = 0;
+
+	if (test) {
+		while (i < n) {
+			fp = (fp << 1) + T[p[i++]];
+			if ((fp & mask) == 0) {
+				break;
+			}
+		}
+	} else {
+		for (; i < n; i++) {
+			fp = (fp << 1) + T[p[i]];
+		}
+	}
+	rp->fingerprint = fp;
+	rp->window_fed = rp->window_fed + i < rp->window_size ?
+			 rp->window_fed + i : rp->window_size;
+	return i;
+}
+
+static int rp_block_scan(RabinPoly *rp) {
+    size_t skip = 0;
+    size_t skipped = 0;
+
+    if (rp->block_resume) {
+        /* rp_push() input ran out in this block last time */
+        rp->block_resume = 0;
+        skip = rp->block_skip;
+        skipped = rp->block_skipped;
+        goto scan;
+    }
 
     rp->block_streampos += rp->block_size;
     rp->block_addr += rp->block_size;
     rp->block_size = 0;
 
+    if (rp->map && rp->block_streampos >= rp->map_next) {
+        rp_map_advise(rp);
+    }
+    if (rp->span) {
+        rp_borrow_resume(rp);
+    }
+
     /*
      * Skip early part of each block -- there appears to be no reason
      * to checksum the first min_block_size-N bytes, because the
@@ -428,22 +1334,36 @@ int rp_block_next(RabinPoly *rp) {
      * @moinakg found similar results, and also seems to think 256 is
      * right: https://moinakg.wordpress.com/tag/rolling-hash/
      *
-    */
-    size_t skip = rp->min_block_size - rp->window_size;
-    size_t data_remaining = rp->inbuf_data_size - (rp->block_addr - rp->inbuf);
-    if ((data_remaining > rp->min_block_size+1) &&
-            (rp->min_block_size > 512)) {
-        rp->block_size += skip;
+     * N = window_size is exactly right: the fingerprint only depends
+     * on the last window_size bytes hashed, so once those are all
+     * this block's, by min_block_size, it's what hashing every byte
+     * would have given, and so is every boundary after that.  We skip
+     * whenever that holds (min_block_size >= 2 * window_size), however
+     * much is buffered; a last block that ends before it catches up
+     * gets its fingerprint fixed by rp_window_exact().
+     */
+    if (rp->min_block_size >= 2 * rp->window_size) {
+        skip = rp->min_block_size - rp->window_size;
+        rp_window_save(rp);
     }
 
+scan:
     for(;;) {
+        size_t avail, n, fed, size;
+        u_int64_t mask;
+        int test;
 
-        if (CUR_ADDR == INBUF_END) {
+        if (CUR_ADDR == INBUF_END && !rp->buffer_only &&
+            rp->inbuf == rp->ownbuf && !rp->span) {
             /* end of input buffer: there's a partial block at the end
              * of the buffer; move it to the beginning of the buffer
-             * so we can append more from input stream
+             * so we can append more from input stream.  Buffers we
+             * don't refill (and borrowed views we must not write to)
+             * are simply at EOF here.
              */
+            rp_window_save(rp);
             memmove(rp->inbuf, rp->block_addr, rp->block_size);
+            rp->stats.bytes_moved += rp->block_size;
             rp->block_addr = rp->inbuf;
             rp->inbuf_data_size = rp->block_size;
         }
@@ -452,25 +1372,20 @@ int rp_block_next(RabinPoly *rp) {
             /* no more valid data in input buffer */
 			int count = 0;
 			if (!rp->error) {
-				if (rp->buffer_only) {
-					/* don't refill buffer */
-					rp->error = EOF;
-				} else {
-					/* use func_stream_read to refill buffer */
-					int size = rp->inbuf_size - rp->inbuf_data_size;
-					assert(size > 0);
-					count = rp_stream_read(rp,
-							       rp->inbuf + rp->inbuf_data_size, size);
-					if (!count) {
-						assert(rp->error);
-					}
-					rp->inbuf_data_size += count;
-				}
+				count = rp_refill(rp);
 			}
 			if (rp->error && (count == 0)) {
 				/* we're either carrying an error from earlier, or the
 				 * func_stream_read above just threw one
 				 */
+				if (rp->error == EAGAIN) {
+					/* rp_push() input ran out: the block goes on
+					 * with the next push */
+					rp->block_resume = 1;
+					rp->block_skip = skip;
+					rp->block_skipped = skipped;
+					return EAGAIN;
+				}
 				if (rp->block_size == 0) {
 					/* we're done. caller shouldn't call us again */
 					return rp->error;
@@ -478,16 +1393,23 @@ int rp_block_next(RabinPoly *rp) {
 					/* give final block to caller; caller should call
 					 * us again to get e.g. eof error
 					 */
+					if (skipped &&
+					    rp->block_size < rp->min_block_size) {
+						rp_window_exact(rp);
+					}
+					rp_count_block(rp, rp->block_size, skipped,
+						       &rp->stats.cuts_end);
 					return 0;
 				}
 			}
         }
 
-        /* feed the next byte into rabinpoly algo */
-        slide8(rp, rp->block_addr[rp->block_size]);
-        rp->block_size++;
-
         /*
+         * Feed the longest run of bytes that are all in the buffer
+         * and all get the same boundary test: none before the byte
+         * that makes min_block_size, then (for gear) the strict mask
+         * until the one that makes avg_block_size, then the loose one
+         * (or rabin's only one) up to max_block_size.
          *
          * We compare the low-order fingerprint bits (LOFB) to
          * something other than zero in order to avoid generating
@@ -502,11 +1424,150 @@ int rp_block_next(RabinPoly *rp) {
          * the mask itself will do the right thing.
          *
          */
-        if ((rp->block_size == rp->max_block_size) ||
-            ((rp->block_size >= rp->min_block_size) &&
-            ((rp->fingerprint & rp->fingerprint_mask) == 0))) {
+        avail = rp->inbuf + rp->inbuf_data_size - (CUR_ADDR);
+        size = rp->block_size;
+        if (size < skip) {
+            n = skip - size < avail ? skip - size : avail;
+            rp->block_size += n;
+            skipped += n;
+            continue;
+        }
+        if (size + 1 < rp->min_block_size) {
+            n = rp->min_block_size - 1 - size;
+            mask = 0;
+            test = 0;
+        } else if (rp->engine == RP_ENGINE_GEAR &&
+                   size + 1 < rp->avg_block_size) {
+            n = rp->avg_block_size - 1 - size;
+            mask = rp->gear_mask_s;
+            test = 1;
+        } else {
+            n = rp->max_block_size - size;
+            mask = rp->engine == RP_ENGINE_GEAR ? rp->gear_mask_l :
+                                                  rp->fingerprint_mask;
+            test = 1;
+        }
+        if (n > avail) {
+            n = avail;
+        }
+
+        if (rp->engine == RP_ENGINE_GEAR) {
+            fed = scan_gear_span(rp, CUR_ADDR, n, mask, test);
+        } else {
+            fed = scan_rabin_span(rp, CUR_ADDR, n, mask, test);
+        }
+        rp->block_size += fed;
+
+        if (fed && (rp->block_size == rp->max_block_size ||
+                    (test && (rp->fingerprint & mask) == 0))) {
             /* full block or fingerprint boundary */
+            rp_count_block(rp, rp->block_size, skipped,
+                           rp->block_size == rp->max_block_size ?
+                           &rp->stats.cuts_max : &rp->stats.cuts_content);
             return 0;
         }
     }
 }
+
+int rp_block_next(RabinPoly *rp) {
+	int rc = rp_block_scan(rp);
+
+	/* while the block is still in cache */
+	if (!rc && rp->digest) {
+		rp_digest_block(rp);
+	}
+	return rc;
+}
+
+/*
+
+    rp_find_boundaries() -- Find up to 'max' blocks in one call
+
+    Fills 'out' with the offset, length and fingerprint of the next
+    blocks in the input, exactly as successive rp_block_next() calls
+    would find them, and returns how many records were written.  This
+    saves a library call per block, which matters most to language
+    bindings, where every call is expensive.
+
+    A return value smaller than 'max' means the input ran out (or
+    failed) and rp->error says why, e.g. EOF.  As with
+    rp_block_next(), block_addr and block_size describe the last
+    block found; earlier blocks may no longer be in the input buffer
+    when reading from a stream, which is why records carry stream
+    offsets rather than addresses.
+
+*/
+
+size_t rp_find_boundaries(RabinPoly *rp, rp_boundary *out, size_t max) {
+	return rp_find_boundaries_digest(rp, out, NULL, max);
+}
+
+/*
+
+    rp_find_boundaries_digest() -- rp_find_boundaries() with digests
+
+    Like rp_find_boundaries(), and also copies each block's digest (see
+    rp_set_digest()) to 'digests', which must have room for 'max'
+    times rp_digest_size() bytes: record i's digest is at
+    digests + i * rp_digest_size().  'digests' may be NULL, and is left
+    alone if no digest is set.
+
+*/
+
+size_t rp_find_boundaries_digest(RabinPoly *rp, rp_boundary *out,
+				 unsigned char *digests, size_t max) {
+	size_t n, size = digests ? rp_digest_size(rp->digest) : 0;
+
+	for (n = 0; n < max; n++) {
+		if (rp_block_next(rp)) {
+			break;
+		}
+		out[n].offset = rp->block_streampos;
+		out[n].length = rp->block_size;
+		out[n].fingerprint = rp->fingerprint;
+		if (size) {
+			memcpy(digests + n * size, rp->block_digest, size);
+		}
+	}
+	return n;
+}
+
+/*
+
+    rp_pull() -- collect the blocks rp_push() input has completed
+
+    rp_find_boundaries() for pushed input: fills 'out' with up to
+    'max' blocks and returns how many.  Fewer than 'max' means
+    rp->error is EAGAIN, and it's time to push the next packet, or
+    EOF after the last block of a stream that's been ended.  The
+    blocks' bytes can be had with rp_block_next() instead, which
+    returns EAGAIN the same way.
+
+*/
+
+size_t rp_pull(RabinPoly *rp, rp_boundary *out, size_t max) {
+	return rp_find_boundaries(rp, out, max);
+}
+
+/*
+
+    rp_get_stats() -- what rp has been up to
+
+    Copies rp's counters (see struct rp_stats) to 'stats'.  They start
+    at zero in rp_new() and add up over every input since, through
+    rp_reset() and the rp_from_*() calls, until rp_clear_stats().
+    Keeping them costs a few additions per block and a clock read
+    around each read from a stream or source, so they're always on.
+
+    calc_rabin() only contributes to the read and bytes_moved
+    counters, as it doesn't cut blocks.
+
+*/
+
+void rp_get_stats(const RabinPoly *rp, rp_stats *stats) {
+	*stats = rp->stats;
+}
+
+void rp_clear_stats(RabinPoly *rp) {
+	memset(&rp->stats, 0, sizeof(rp->stats));
+}
@@ -27,47 +27,211 @@
 #include <stdio.h>
 #include <sys/types.h>
 
+/*
+ * Boundary engines, chosen when a RabinPoly is created.
+ */
+enum rp_engine {
+	RP_ENGINE_RABIN = 0,	    // rabin fingerprint over a sliding window
+	RP_ENGINE_GEAR = 1,	    // FastCDC-style gear hash, normalized chunking
+};
+
+/*
+ * Per-block digests, see rp_set_digest().
+ */
+enum rp_digest {
+	RP_DIGEST_NONE = 0,
+	RP_DIGEST_XXH3_128 = 1,	    // 16 bytes of xxh3-128: dedup keys
+	RP_DIGEST_BLAKE3 = 2,	    // 32 bytes of BLAKE3: content addresses
+};
+
+#define RP_DIGEST_MAX 32	    // largest rp_digest_size()
+
+struct rp_tables;
+
+/*
+ * Where rp_from_source() gets its input.  Set 'read', 'borrow', or
+ * both; borrowing is used when it's there.  Either one returns 0 at
+ * the end of the input or on an error, and then sets *error to EOF or
+ * an errno value.
+ */
+typedef struct rp_source {
+	// copy up to 'size' bytes into 'dst', return how many
+	size_t (*read)(void *ctx, unsigned char *dst, size_t size, int *error);
+	// lend the next bytes in place: return them and set *size; they
+	// must stay put until the next borrow() or close()
+	const unsigned char *(*borrow)(void *ctx, size_t *size, int *error);
+	// optional; called when rp is done with the source
+	void (*close)(void *ctx);
+} rp_source;
+
+#define RP_STATS_BUCKETS 32
+
+/*
+ * Counters every RabinPoly keeps as it goes, see rp_get_stats().
+ * Histogram bucket i counts values from 2^i up to 2^(i+1) - 1; the
+ * last one also takes everything larger.
+ */
+typedef struct rp_stats {
+	u_int64_t bytes_scanned;    // bytes run through the rolling hash
+	u_int64_t bytes_skipped;    // bytes passed over at block starts
+	u_int64_t bytes_moved;	    // partial block bytes moved in inbuf
+	u_int64_t bytes_read;	    // bytes read or borrowed from the input
+	u_int64_t refills;	    // reads (or borrows) from the input
+	u_int64_t read_ns;	    // wall time they took, in nanoseconds
+	u_int64_t read_ns_max;	    // the slowest one
+	u_int64_t blocks;	    // blocks found
+	u_int64_t cuts_content;	    // blocks ended by the fingerprint
+	u_int64_t cuts_max;	    // blocks ended at max_block_size
+	u_int64_t cuts_end;	    // blocks ended by the end of the input
+	u_int64_t block_sizes[RP_STATS_BUCKETS]; // blocks by size in bytes
+	u_int64_t read_times[RP_STATS_BUCKETS];  // refills by time in ns
+} rp_stats;
+
 typedef struct RabinPoly {
 	//Private config values
-	u_int64_t poly;		    // Actual polynomial
+	u_int64_t poly;		    // Actual polynomial (gear: table seed)
+	enum rp_engine engine;	    // boundary engine
 	unsigned int window_size;   // in bytes
 	size_t avg_block_size;	    // in bytes
 	size_t min_block_size;	    // in bytes
 	size_t max_block_size;	    // in bytes
 
 	//PRIVATE
-	unsigned char *inbuf;	    // input buffer
+	unsigned char *inbuf;	    // input buffer (own buffer or borrowed view)
 	size_t inbuf_size;	    // size of input buffer
 	size_t inbuf_data_size;     // size of valid data in input buffer
+	unsigned char *ownbuf;	    // buffer allocated by rp_new()
+	size_t ownbuf_size;	    // size of ownbuf
 
 	u_int64_t fingerprint_mask; // to check if we are at block boundary
+	u_int64_t gear_mask_s;	    // gear: stricter mask below avg_block_size
+	u_int64_t gear_mask_l;	    // gear: looser mask from avg_block_size on
 
-	unsigned char *circbuf;	    // circular buffer of size 'window_size'
-	unsigned int circbuf_pos;   // current position in circular buffer
+	unsigned char *window;	    // the window at the last seam, oldest first
+	unsigned int window_fed;    // bytes hashed since, up to window_size
 	FILE *stream;		    // input stream
+	int stream_owned;	    // stream was opened by rp_from_file()
+	unsigned char *map;	    // rp_from_file() mapping, if any
+	size_t map_size;	    // size of map
+	size_t map_released;	    // map offset up to which pages were dropped
+	size_t map_next;	    // stream position of next madvise() update
 	int error;		    // input stream errno
 	int buffer_only;	    // if set, read loaded buffer only; ignore stream
 	int shift;
-	u_int64_t T[256];	    // Lookup table for mod
-	u_int64_t U[256];	    // Lookup table for subtraction
+	const u_int64_t *T;	    // Lookup table for mod (gear: gear table)
+	const u_int64_t *U;	    // Lookup table for subtraction
+	struct rp_tables *tables;   // shared, refcounted storage for T and U
 	size_t (*func_stream_read)(struct RabinPoly*, unsigned char *dst, size_t size);
+	const rp_source *source;    // rp_from_source() source, if any
+	void *source_ctx;	    // its context
+	const unsigned char *span;  // borrowed bytes, from source->borrow()
+	size_t span_size;	    // size of span
+	size_t span_pos;	    // bytes of span taken into the input so far
+	const unsigned char *push_data; // rp_push() packet not taken in yet
+	size_t push_size;	    // its size
+	int push_eof;		    // rp_push() said the input is over
+	int block_resume;	    // the block goes on once there's input
+	size_t block_skip;	    // bytes at its start not to hash
+	size_t block_skipped;	    // how many of those are behind us
+	enum rp_digest digest;	    // set by rp_set_digest()
+	rp_stats stats;		    // see rp_get_stats()
 
 	//PUB
 	u_int64_t fingerprint;	    // current rabin fingerprint
 	size_t block_streampos;	    // block start position in input stream
 	unsigned char * block_addr; // starting address of current block
 	size_t block_size;	    // size of the current block
+	unsigned char block_digest[RP_DIGEST_MAX]; // its digest, if enabled
 } RabinPoly;
 
+/*
+ * One block as reported by rp_find_boundaries().
+ */
+typedef struct rp_boundary {
+	size_t offset;		    // block start position in input stream
+	size_t length;		    // block size in bytes
+	u_int64_t fingerprint;	    // rabin fingerprint at end of block
+} rp_boundary;
+
+/*
+ * A position reported by rp_fingerprint_matches().
+ */
+typedef struct rp_match {
+	size_t pos;		    // position of the byte that ends the window
+	u_int64_t fingerprint;	    // fingerprint after that byte
+} rp_match;
+
+/*
+ * A fixed-size index of blocks seen, for dedup: see rp_dedup_new().
+ * Blocks are keyed by the first RP_DEDUP_KEY bytes of their digest.
+ */
+#define RP_DEDUP_KEY 16
+
+struct rp_dedup;
+
+typedef struct rp_dedup_entry {
+	unsigned char key[RP_DEDUP_KEY]; // digest prefix
+	u_int64_t offset;	    // where the block was first seen
+	u_int64_t refs;		    // times it has been seen; 0: free slot
+	u_int32_t file;		    // input it was first seen in
+	u_int32_t length;	    // block size in bytes
+} rp_dedup_entry;
+
+typedef struct rp_dedup_stats {
+	u_int64_t blocks;	    // blocks counted
+	u_int64_t bytes;	    // and their total size
+	u_int64_t unique_blocks;    // of those, blocks not seen before
+	u_int64_t unique_bytes;	    // and their total size
+	u_int64_t untracked_blocks; // unique ones the full index dropped
+} rp_dedup_stats;
+
 extern RabinPoly *rp_new(unsigned int window_size, size_t avg_block_size,
 			 size_t min_block_size, size_t max_block_size,
 			 size_t inbuf_size, u_int64_t poly);
+extern RabinPoly *rp_new_engine(enum rp_engine engine,
+				unsigned int window_size, size_t avg_block_size,
+				size_t min_block_size, size_t max_block_size,
+				size_t inbuf_size, u_int64_t poly);
 extern void rp_from_buffer(RabinPoly *rp, unsigned char *src, size_t size);
+extern void rp_from_view(RabinPoly *rp, const void *src, size_t size);
 extern void rp_from_file(RabinPoly *rp, const char *path);
 extern void rp_from_stream(RabinPoly *rp, FILE *);
+extern void rp_from_source(RabinPoly *rp, const rp_source *src, void *ctx);
+extern int rp_push(RabinPoly *rp, const void *data, size_t size);
+extern size_t rp_pull(RabinPoly *rp, rp_boundary *out, size_t max);
 extern int rp_block_next(RabinPoly *rp);
+extern size_t rp_find_boundaries(RabinPoly *rp, rp_boundary *out, size_t max);
+extern size_t rp_find_boundaries_digest(RabinPoly *rp, rp_boundary *out,
+					unsigned char *digests, size_t max);
+extern size_t rp_find_boundaries_parallel(RabinPoly *rp, rp_boundary *out,
+					  size_t max, int nthreads);
+extern int rp_set_digest(RabinPoly *rp, enum rp_digest kind);
+extern size_t rp_digest_size(enum rp_digest kind);
+extern void rp_digest(enum rp_digest kind, const void *src, size_t size,
+		      unsigned char *out);
+extern void rp_get_stats(const RabinPoly *rp, rp_stats *stats);
+extern void rp_clear_stats(RabinPoly *rp);
+extern void *rp_buffer_get(size_t size);
+extern void rp_buffer_put(void *buf);
+extern void rp_buffer_trim(void);
+extern void rp_reset(RabinPoly *rp);
 extern void rp_free(RabinPoly *rp);
 extern int calc_rabin(RabinPoly *rp);
+extern void rp_fingerprints(const RabinPoly *rp, const void *src, size_t from,
+			    size_t to, u_int64_t *out);
+extern size_t rp_fingerprint_matches(const RabinPoly *rp, const void *src,
+				     size_t from, size_t to, u_int64_t mask,
+				     rp_match *out, size_t max);
+extern struct rp_dedup *rp_dedup_new(enum rp_digest digest, size_t memory);
+extern void rp_dedup_free(struct rp_dedup *d);
+extern int rp_dedup_add(struct rp_dedup *d, const unsigned char *digest,
+			size_t length, u_int32_t file, u_int64_t offset,
+			rp_dedup_stats *stats);
+extern int rp_dedup_scan(struct rp_dedup *d, RabinPoly *rp, u_int32_t file,
+			 rp_dedup_stats *stats);
+extern const rp_dedup_entry *rp_dedup_lookup(const struct rp_dedup *d,
+					     const unsigned char *digest);
+extern void rp_dedup_totals(const struct rp_dedup *d, rp_dedup_stats *stats);
 
 #endif /* !_RABINPOLY_H_ */
 
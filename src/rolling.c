@@ -0,0 +1,581 @@
+/*
+ * Copyright (C) 2026 The simdedup contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+ * USA
+ *
+ */
+
+/*
+ * Rolling fingerprints at every byte of a buffer, several lanes at a
+ * time.
+ *
+ * calc_rabin() produces one fingerprint per call, and each one
+ * depends on the previous one through two table lookups, so a single
+ * stream can never go faster than that chain of loads.  The
+ * fingerprint at any position only depends on the window_size bytes
+ * ending there, though.  So we cut the buffer into independent lanes,
+ * warm each lane up on the window_size - 1 bytes before its start, and
+ * run the lanes side by side: interleaved in scalar code, or in the
+ * elements of an AVX2 or AVX-512 vector using gathers for the table
+ * lookups.  All of them produce exactly what slide8() would.
+ *
+ * Which kernel runs is decided at runtime: of the ones the CPU
+ * supports, the first use times each on a scratch buffer and keeps the
+ * fastest.  Gathers are slow on some parts (and much slower again with
+ * some microcode mitigations), so the feature bits alone don't say
+ * which wins.  Setting RABINPOLY_SIMD to "scalar", "avx2" or "avx512"
+ * in the environment skips the timing and picks that kernel if the
+ * CPU has it.
+ */
+
+#include "rabinpoly.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <time.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HAVE_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+/* fingerprints computed per pass when filtering */
+#define MATCH_BATCH (64*1024)
+
+/* below this many positions per lane the warmup isn't worth it */
+#define MIN_LANE_LEN 4096
+
+#define MAX_LANES 8
+
+/* bytes each candidate kernel is timed on */
+#define CALIBRATE_LEN (MAX_LANES * MIN_LANE_LEN * 4)
+
+/*
+ * Everything a kernel needs to know about one run of positions: the
+ * input, where the window was warmed up from, and where to put the
+ * results.
+ */
+struct lane {
+	const unsigned char *src;   // start of the stream
+	size_t warm;		    // first byte that's part of the window
+	size_t pos;		    // next position to compute
+	size_t end;		    // one past the last position
+	u_int64_t fp;		    // fingerprint at pos - 1
+	u_int64_t *out;		    // where the fingerprint for pos goes
+};
+
+typedef void (*lanes_fn)(const RabinPoly *rp, struct lane *lanes,
+			 size_t count);
+
+static inline u_int64_t rabin_step(const RabinPoly *rp, u_int64_t fp,
+				   unsigned char om, unsigned char m) {
+	fp ^= rp->U[om];
+	return ((fp << 8) | m) ^ rp->T[fp >> rp->shift];
+}
+
+static inline u_int64_t gear_step(const RabinPoly *rp, u_int64_t fp,
+				  unsigned char m) {
+	return (fp << 1) + rp->T[m];
+}
+
+/*
+ * Start a lane at 'pos': feed the bytes before it that are still in
+ * the window into an empty fingerprint.
+ */
+static void lane_init(const RabinPoly *rp, struct lane *l,
+		      const unsigned char *src, size_t pos, size_t end,
+		      u_int64_t *out) {
+	size_t i;
+
+	l->src = src;
+	l->warm = pos >= rp->window_size - 1 ? pos - (rp->window_size - 1) : 0;
+	l->pos = pos;
+	l->end = end;
+	l->out = out;
+	l->fp = 0;
+	for (i = l->warm; i < pos; i++) {
+		if (rp->engine == RP_ENGINE_GEAR) {
+			l->fp = gear_step(rp, l->fp, src[i]);
+		} else {
+			l->fp = rabin_step(rp, l->fp, 0, src[i]);
+		}
+	}
+}
+
+/*
+ * Advance a single lane by up to 'count' positions, one at a time.
+ * Also used for the first few positions of a lane, before a full
+ * window of its own bytes has gone by.
+ */
+static void lane_scalar(const RabinPoly *rp, struct lane *l, size_t count) {
+	const unsigned char *src = l->src;
+	size_t w = rp->window_size;
+	size_t end = l->pos + count;
+	u_int64_t fp = l->fp;
+	size_t p;
+
+	if (end > l->end) {
+		end = l->end;
+	}
+	if (rp->engine == RP_ENGINE_GEAR) {
+		for (p = l->pos; p < end; p++) {
+			*l->out++ = fp = gear_step(rp, fp, src[p]);
+		}
+	} else {
+		for (p = l->pos; p < end; p++) {
+			unsigned char om = p >= l->warm + w ? src[p - w] : 0;
+			*l->out++ = fp = rabin_step(rp, fp, om, src[p]);
+		}
+	}
+	l->fp = fp;
+	l->pos = end;
+}
+
+/*
+ * The portable kernel: four lanes interleaved, so the CPU has four
+ * independent chains of lookups to overlap.  Lanes must be past
+ * their warmup.
+ */
+static void lanes_scalar(const RabinPoly *rp, struct lane *lanes,
+			 size_t count) {
+	const unsigned char *s0 = lanes[0].src, *s1 = lanes[1].src;
+	const unsigned char *s2 = lanes[2].src, *s3 = lanes[3].src;
+	size_t p0 = lanes[0].pos, p1 = lanes[1].pos;
+	size_t p2 = lanes[2].pos, p3 = lanes[3].pos;
+	u_int64_t f0 = lanes[0].fp, f1 = lanes[1].fp;
+	u_int64_t f2 = lanes[2].fp, f3 = lanes[3].fp;
+	u_int64_t *o0 = lanes[0].out, *o1 = lanes[1].out;
+	u_int64_t *o2 = lanes[2].out, *o3 = lanes[3].out;
+	size_t w = rp->window_size;
+	size_t i;
+
+	if (rp->engine == RP_ENGINE_GEAR) {
+		for (i = 0; i < count; i++) {
+			o0[i] = f0 = gear_step(rp, f0, s0[p0 + i]);
+			o1[i] = f1 = gear_step(rp, f1, s1[p1 + i]);
+			o2[i] = f2 = gear_step(rp, f2, s2[p2 + i]);
+			o3[i] = f3 = gear_step(rp, f3, s3[p3 + i]);
+		}
+	} else {
+		for (i = 0; i < count; i++) {
+			o0[i] = f0 = rabin_step(rp, f0, s0[p0 + i - w], s0[p0 + i]);
+			o1[i] = f1 = rabin_step(rp, f1, s1[p1 + i - w], s1[p1 + i]);
+			o2[i] = f2 = rabin_step(rp, f2, s2[p2 + i - w], s2[p2 + i]);
+			o3[i] = f3 = rabin_step(rp, f3, s3[p3 + i - w], s3[p3 + i]);
+		}
+	}
+
+	for (i = 0; i < 4; i++) {
+		lanes[i].pos += count;
+		lanes[i].out += count;
+	}
+	lanes[0].fp = f0;
+	lanes[1].fp = f1;
+	lanes[2].fp = f2;
+	lanes[3].fp = f3;
+}
+
+#ifdef HAVE_X86_SIMD
+
+/*
+ * The vector kernels hold one lane per 64 bit element.  Input bytes
+ * are fetched eight at a time per lane and peeled off with shifts,
+ * and the U[]/T[] lookups become gathers.  Only rabin is vectorized;
+ * gear is cheap enough that the scalar kernel keeps up.
+ */
+
+static inline u_int64_t load64(const unsigned char *p) {
+	u_int64_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+__attribute__((target("avx2")))
+static void lanes_avx2(const RabinPoly *rp, struct lane *lanes,
+		       size_t count) {
+	const long long *T = (const long long *)rp->T;
+	const long long *U = (const long long *)rp->U;
+	const __m128i shift = _mm_cvtsi32_si128(rp->shift);
+	const __m256i bytemask = _mm256_set1_epi64x(0xff);
+	size_t w = rp->window_size;
+	u_int64_t fps[4] __attribute__((aligned(32)));
+	__m256i fp;
+	size_t i;
+	int j, k;
+
+	for (k = 0; k < 4; k++) {
+		fps[k] = lanes[k].fp;
+	}
+	fp = _mm256_load_si256((const __m256i *)fps);
+
+	for (i = 0; i + 8 <= count; i += 8) {
+		const unsigned char *in[4];
+		__m256i m8, om8;
+
+		for (k = 0; k < 4; k++) {
+			in[k] = lanes[k].src + lanes[k].pos + i;
+		}
+		m8 = _mm256_set_epi64x(load64(in[3]), load64(in[2]),
+				       load64(in[1]), load64(in[0]));
+		om8 = _mm256_set_epi64x(load64(in[3] - w), load64(in[2] - w),
+					load64(in[1] - w), load64(in[0] - w));
+
+		for (j = 0; j < 8; j++) {
+			__m256i m = _mm256_and_si256(m8, bytemask);
+			__m256i om = _mm256_and_si256(om8, bytemask);
+			__m256i t;
+
+			m8 = _mm256_srli_epi64(m8, 8);
+			om8 = _mm256_srli_epi64(om8, 8);
+
+			fp = _mm256_xor_si256(fp, _mm256_i64gather_epi64(U, om, 8));
+			t = _mm256_i64gather_epi64(T, _mm256_srl_epi64(fp, shift), 8);
+			fp = _mm256_xor_si256(_mm256_or_si256(
+				_mm256_slli_epi64(fp, 8), m), t);
+
+			_mm256_store_si256((__m256i *)fps, fp);
+			for (k = 0; k < 4; k++) {
+				lanes[k].out[i + j] = fps[k];
+			}
+		}
+	}
+
+	_mm256_store_si256((__m256i *)fps, fp);
+	for (k = 0; k < 4; k++) {
+		lanes[k].fp = fps[k];
+		lanes[k].pos += i;
+		lanes[k].out += i;
+	}
+	/* leftovers */
+	for (k = 0; k < 4; k++) {
+		lane_scalar(rp, &lanes[k], count - i);
+	}
+}
+
+__attribute__((target("avx512f")))
+static void lanes_avx512(const RabinPoly *rp, struct lane *lanes,
+			 size_t count) {
+	const long long *T = (const long long *)rp->T;
+	const long long *U = (const long long *)rp->U;
+	const __m128i shift = _mm_cvtsi32_si128(rp->shift);
+	const __m512i bytemask = _mm512_set1_epi64(0xff);
+	size_t w = rp->window_size;
+	u_int64_t fps[8] __attribute__((aligned(64)));
+	__m512i fp;
+	size_t i;
+	int j, k;
+
+	for (k = 0; k < 8; k++) {
+		fps[k] = lanes[k].fp;
+	}
+	fp = _mm512_load_si512(fps);
+
+	for (i = 0; i + 8 <= count; i += 8) {
+		const unsigned char *in[8];
+		__m512i m8, om8;
+
+		for (k = 0; k < 8; k++) {
+			in[k] = lanes[k].src + lanes[k].pos + i;
+		}
+		m8 = _mm512_set_epi64(load64(in[7]), load64(in[6]),
+				      load64(in[5]), load64(in[4]),
+				      load64(in[3]), load64(in[2]),
+				      load64(in[1]), load64(in[0]));
+		om8 = _mm512_set_epi64(load64(in[7] - w), load64(in[6] - w),
+				       load64(in[5] - w), load64(in[4] - w),
+				       load64(in[3] - w), load64(in[2] - w),
+				       load64(in[1] - w), load64(in[0] - w));
+
+		for (j = 0; j < 8; j++) {
+			__m512i m = _mm512_and_si512(m8, bytemask);
+			__m512i om = _mm512_and_si512(om8, bytemask);
+			__m512i t;
+
+			m8 = _mm512_srli_epi64(m8, 8);
+			om8 = _mm512_srli_epi64(om8, 8);
+
+			fp = _mm512_xor_si512(fp, _mm512_i64gather_epi64(om, U, 8));
+			t = _mm512_i64gather_epi64(_mm512_srl_epi64(fp, shift), T, 8);
+			fp = _mm512_xor_si512(_mm512_or_si512(
+				_mm512_slli_epi64(fp, 8), m), t);
+
+			_mm512_store_si512(fps, fp);
+			for (k = 0; k < 8; k++) {
+				lanes[k].out[i + j] = fps[k];
+			}
+		}
+	}
+
+	_mm512_store_si512(fps, fp);
+	for (k = 0; k < 8; k++) {
+		lanes[k].fp = fps[k];
+		lanes[k].pos += i;
+		lanes[k].out += i;
+	}
+	for (k = 0; k < 8; k++) {
+		lane_scalar(rp, &lanes[k], count - i);
+	}
+}
+
+#endif /* HAVE_X86_SIMD */
+
+struct kernel {
+	const char *name;
+	lanes_fn fn;
+	int nlanes;
+};
+
+static const struct kernel kernel_scalar = { "scalar", lanes_scalar, 4 };
+#ifdef HAVE_X86_SIMD
+static const struct kernel kernel_avx2 = { "avx2", lanes_avx2, 4 };
+static const struct kernel kernel_avx512 = { "avx512", lanes_avx512, 8 };
+#endif
+
+static void roll_with(const struct kernel *k, const RabinPoly *rp,
+		      const unsigned char *src, size_t from, size_t to,
+		      u_int64_t *out);
+
+static double kernel_time(const struct kernel *k, const RabinPoly *rp,
+			  const unsigned char *src, u_int64_t *out) {
+	struct timespec a, b;
+	double best = 0;
+	int i;
+
+	for (i = 0; i < 3; i++) {
+		double t;
+
+		clock_gettime(CLOCK_MONOTONIC, &a);
+		roll_with(k, rp, src, 0, CALIBRATE_LEN, out);
+		clock_gettime(CLOCK_MONOTONIC, &b);
+		t = (b.tv_sec - a.tv_sec) + (b.tv_nsec - a.tv_nsec) / 1e9;
+		if (!i || t < best) {
+			best = t;
+		}
+	}
+	return best;
+}
+
+/*
+ * Of the kernels this CPU supports, time each on some pseudo random
+ * input and return the fastest.  If there's no memory for that, trust
+ * the feature bits.
+ */
+static const struct kernel *calibrate(const RabinPoly *rp,
+				      const struct kernel **cand, int n) {
+	const struct kernel *k = cand[n - 1];
+	unsigned char *src;
+	u_int64_t *out, x = 0x9e3779b97f4a7c15ULL;
+	double best = 0;
+	size_t j;
+	int i;
+
+	if (n == 1) {
+		return k;
+	}
+	src = malloc(CALIBRATE_LEN);
+	out = malloc(CALIBRATE_LEN * sizeof(*out));
+	if (src && out) {
+		for (j = 0; j < CALIBRATE_LEN; j++) {
+			x ^= x << 13;
+			x ^= x >> 7;
+			x ^= x << 17;
+			src[j] = x;
+		}
+		for (i = 0; i < n; i++) {
+			double t = kernel_time(cand[i], rp, src, out);
+
+			if (!i || t < best) {
+				best = t;
+				k = cand[i];
+			}
+		}
+	}
+	free(src);
+	free(out);
+	return k;
+}
+
+/*
+ * Pick the kernel to use for rabin (see the top of the file).  Racing
+ * callers may both calibrate, but either answer is fine, so no locking
+ * is needed.
+ */
+static const struct kernel *pick_kernel(const RabinPoly *rp) {
+	static const struct kernel *best;
+	const struct kernel *cand[3], *k;
+	const char *want;
+	int n = 0;
+
+	if (rp->engine == RP_ENGINE_GEAR) {
+		return &kernel_scalar;
+	}
+	k = __atomic_load_n(&best, __ATOMIC_ACQUIRE);
+	if (k) {
+		return k;
+	}
+
+	want = getenv("RABINPOLY_SIMD");
+	if (!want || !strcmp(want, "scalar")) {
+		cand[n++] = &kernel_scalar;
+	}
+#ifdef HAVE_X86_SIMD
+	__builtin_cpu_init();
+	if ((!want || !strcmp(want, "avx2")) &&
+	    __builtin_cpu_supports("avx2")) {
+		cand[n++] = &kernel_avx2;
+	}
+	if ((!want || !strcmp(want, "avx512")) &&
+	    __builtin_cpu_supports("avx512f")) {
+		cand[n++] = &kernel_avx512;
+	}
+#endif
+	if (!n) {
+		/* asked for something we don't have */
+		cand[n++] = &kernel_scalar;
+	}
+	k = calibrate(rp, cand, n);
+	__atomic_store_n(&best, k, __ATOMIC_RELEASE);
+	return k;
+}
+
+/*
+ * Fill out[0 .. to-from) with the fingerprints at positions from..to-1
+ * of src, using as many lanes as the kernel has when that's worthwhile.
+ */
+static void roll(const RabinPoly *rp, const unsigned char *src,
+		 size_t from, size_t to, u_int64_t *out) {
+	roll_with(pick_kernel(rp), rp, src, from, to, out);
+}
+
+static void roll_with(const struct kernel *k, const RabinPoly *rp,
+		      const unsigned char *src, size_t from, size_t to,
+		      u_int64_t *out) {
+	struct lane lanes[MAX_LANES];
+	size_t w = rp->window_size;
+	size_t len, n, common;
+	int i;
+
+	if (to <= from) {
+		return;
+	}
+
+	n = to - from;
+	if (n < (size_t)k->nlanes * MIN_LANE_LEN) {
+		lane_init(rp, &lanes[0], src, from, to, out);
+		lane_scalar(rp, &lanes[0], n);
+		return;
+	}
+
+	len = n / k->nlanes;
+	for (i = 0; i < k->nlanes; i++) {
+		size_t start = from + i * len;
+		size_t end = i == k->nlanes - 1 ? to : start + len;
+
+		lane_init(rp, &lanes[i], src, start, end, out + (start - from));
+		/*
+		 * Until a whole window of the lane's own input has gone
+		 * by, the outgoing byte may be one of the zeros before
+		 * the start of the stream; the kernels don't check.
+		 */
+		if (lanes[i].pos < lanes[i].warm + w) {
+			lane_scalar(rp, &lanes[i], lanes[i].warm + w - lanes[i].pos);
+		}
+	}
+
+	common = (size_t)-1;
+	for (i = 0; i < k->nlanes; i++) {
+		if (lanes[i].end - lanes[i].pos < common) {
+			common = lanes[i].end - lanes[i].pos;
+		}
+	}
+	k->fn(rp, lanes, common);
+	for (i = 0; i < k->nlanes; i++) {
+		lane_scalar(rp, &lanes[i], lanes[i].end - lanes[i].pos);
+	}
+}
+
+/*
+
+    rp_fingerprints() -- rolling fingerprint at every position
+
+    Computes the fingerprint the engine has after each byte in
+    positions 'from' .. 'to'-1 of 'src', and stores the one for
+    position i in out[i - from].  'src' is taken to be the start of
+    the stream, so the results are bit for bit what calc_rabin()
+    would yield after rp_from_view(rp, src, to); bytes before 'from'
+    are only read to fill the window.  rp's own stream state is left
+    alone.
+
+*/
+
+void rp_fingerprints(const RabinPoly *rp, const void *src, size_t from,
+		     size_t to, u_int64_t *out) {
+	roll(rp, src, from, to, out);
+}
+
+/*
+
+    rp_fingerprint_matches() -- positions whose fingerprint has
+    (fingerprint & mask) == 0
+
+    Like rp_fingerprints(), but only reports the positions in
+    'from' .. 'to'-1 that pass the mask test, in increasing order, as
+    rp_match records.  At most 'max' records are written; the return
+    value is how many.  If it's 'max' there may be more: carry on from
+    the position after the last one reported.
+
+    Returns 0 and sets errno if it runs out of memory.
+
+*/
+
+size_t rp_fingerprint_matches(const RabinPoly *rp, const void *src,
+			      size_t from, size_t to, u_int64_t mask,
+			      rp_match *out, size_t max) {
+	u_int64_t *fps;
+	size_t n = 0;
+
+	if (from >= to || !max) {
+		return 0;
+	}
+
+	fps = malloc(MATCH_BATCH * sizeof(*fps));
+	if (!fps) {
+		errno = ENOMEM;
+		return 0;
+	}
+
+	while (from < to) {
+		size_t end = to - from > MATCH_BATCH ? from + MATCH_BATCH : to;
+		size_t i;
+
+		roll(rp, src, from, end, fps);
+		for (i = from; i < end; i++) {
+			if ((fps[i - from] & mask) == 0) {
+				out[n].pos = i;
+				out[n].fingerprint = fps[i - from];
+				if (++n == max) {
+					goto out;
+				}
+			}
+		}
+		from = end;
+	}
+out:
+	free(fps);
+	return n;
+}
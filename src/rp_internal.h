@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2026 The simdedup contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+ * USA
+ *
+ */
+
+/*
+ * What the library's source files share with each other but not with
+ * its users.  Nothing here is installed, and it's all hidden, so none
+ * of it ends up in librabinpoly.so's ABI.
+ */
+
+#ifndef _RP_INTERNAL_H_
+#define _RP_INTERNAL_H_
+
+#include "rabinpoly.h"
+
+#define RP_HIDDEN __attribute__((visibility("hidden")))
+
+/* rabinpoly.c */
+RP_HIDDEN void rp_map_advise(RabinPoly *rp);
+RP_HIDDEN void rp_count_block(RabinPoly *rp, size_t length, size_t skipped,
+			      u_int64_t *cut);
+
+/* digest.c */
+RP_HIDDEN void rp_digest_block(RabinPoly *rp);
+
+#endif /* !_RP_INTERNAL_H_ */
@@ -0,0 +1,807 @@
+/* generated by mktables.py -- do not edit */
+
+struct builtin_tables {
+	u_int64_t poly;
+	unsigned int window_size;
+	int shift;
+	u_int64_t T[256];
+	u_int64_t U[256];
+};
+
+static const struct builtin_tables builtin_tables[] = {
+	{
+		.poly = 0xbfe6b8a5bf378d83ULL,
+		.window_size = 32,
+		.shift = 55,
+		.T = {
+			0x0000000000000000ULL, 0xbfe6b8a5bf378d83ULL,
+			0x7fcd714b7e6f1b06ULL, 0xc02bc9eec1589685ULL,
+			0x407c5a3343e9bb8fULL, 0xff9ae296fcde360cULL,
+			0x3fb12b783d86a089ULL, 0x805793dd82b12d0aULL,
+			0x3f1e0cc338e4fa9dULL, 0x80f8b46687d3771eULL,
+			0x40d37d88468be19bULL, 0xff35c52df9bc6c18ULL,
+			0x7f6256f07b0d4112ULL, 0xc084ee55c43acc91ULL,
+			0x00af27bb05625a14ULL, 0xbf499f1eba55d797ULL,
+			0x7e3c198671c9f53aULL, 0xc1daa123cefe78b9ULL,
+			0x01f168cd0fa6ee3cULL, 0xbe17d068b09163bfULL,
+			0x3e4043b532204eb5ULL, 0x81a6fb108d17c336ULL,
+			0x418d32fe4c4f55b3ULL, 0xfe6b8a5bf378d830ULL,
+			0x41221545492d0fa7ULL, 0xfec4ade0f61a8224ULL,
+			0x3eef640e374214a1ULL, 0x8109dcab88759922ULL,
+			0x015e4f760ac4b428ULL, 0xbeb8f7d3b5f339abULL,
+			0x7e933e3d74abaf2eULL, 0xc1758698cb9c22adULL,
+			0x439e8ba95ca467f7ULL, 0xfc78330ce393ea74ULL,
+			0x3c53fae222cb7cf1ULL, 0x83b542479dfcf172ULL,
+			0x03e2d19a1f4ddc78ULL, 0xbc04693fa07a51fbULL,
+			0x7c2fa0d16122c77eULL, 0xc3c91874de154afdULL,
+			0x7c80876a64409d6aULL, 0xc3663fcfdb7710e9ULL,
+			0x034df6211a2f866cULL, 0xbcab4e84a5180befULL,
+			0x3cfcdd5927a926e5ULL, 0x831a65fc989eab66ULL,
+			0x4331ac1259c63de3ULL, 0xfcd714b7e6f1b060ULL,
+			0x3da2922f2d6d92cdULL, 0x82442a8a925a1f4eULL,
+			0x426fe364530289cbULL, 0xfd895bc1ec350448ULL,
+			0x7ddec81c6e842942ULL, 0xc23870b9d1b3a4c1ULL,
+			0x0213b95710eb3244ULL, 0xbdf501f2afdcbfc7ULL,
+			0x02bc9eec15896850ULL, 0xbd5a2649aabee5d3ULL,
+			0x7d71efa76be67356ULL, 0xc2975702d4d1fed5ULL,
+			0x42c0c4df5660d3dfULL, 0xfd267c7ae9575e5cULL,
+			0x3d0db594280fc8d9ULL, 0x82eb0d319738455aULL,
+			0x38dbaff7067f426dULL, 0x873d1752b948cfeeULL,
+			0x4716debc7810596bULL, 0xf8f06619c727d4e8ULL,
+			0x78a7f5c44596f9e2ULL, 0xc7414d61faa17461ULL,
+			0x076a848f3bf9e2e4ULL, 0xb88c3c2a84ce6f67ULL,
+			0x07c5a3343e9bb8f0ULL, 0xb8231b9181ac3573ULL,
+			0x7808d27f40f4a3f6ULL, 0xc7ee6adaffc32e75ULL,
+			0x47b9f9077d72037fULL, 0xf85f41a2c2458efcULL,
+			0x3874884c031d1879ULL, 0x879230e9bc2a95faULL,
+			0x46e7b67177b6b757ULL, 0xf9010ed4c8813ad4ULL,
+			0x392ac73a09d9ac51ULL, 0x86cc7f9fb6ee21d2ULL,
+			0x069bec42345f0cd8ULL, 0xb97d54e78b68815bULL,
+			0x79569d094a3017deULL, 0xc6b025acf5079a5dULL,
+			0x79f9bab24f524dcaULL, 0xc61f0217f065c049ULL,
+			0x0634cbf9313d56ccULL, 0xb9d2735c8e0adb4fULL,
+			0x3985e0810cbbf645ULL, 0x86635824b38c7bc6ULL,
+			0x464891ca72d4ed43ULL, 0xf9ae296fcde360c0ULL,
+			0x7b45245e5adb259aULL, 0xc4a39cfbe5eca819ULL,
+			0x0488551524b43e9cULL, 0xbb6eedb09b83b31fULL,
+			0x3b397e6d19329e15ULL, 0x84dfc6c8a6051396ULL,
+			0x44f40f26675d8513ULL, 0xfb12b783d86a0890ULL,
+			0x445b289d623fdf07ULL, 0xfbbd9038dd085284ULL,
+			0x3b9659d61c50c401ULL, 0x8470e173a3674982ULL,
+			0x042772ae21d66488ULL, 0xbbc1ca0b9ee1e90bULL,
+			0x7bea03e55fb97f8eULL, 0xc40cbb40e08ef20dULL,
+			0x05793dd82b12d0a0ULL, 0xba9f857d94255d23ULL,
+			0x7ab44c93557dcba6ULL, 0xc552f436ea4a4625ULL,
+			0x450567eb68fb6b2fULL, 0xfae3df4ed7cce6acULL,
+			0x3ac816a016947029ULL, 0x852eae05a9a3fdaaULL,
+			0x3a67311b13f62a3dULL, 0x858189beacc1a7beULL,
+			0x45aa40506d99313bULL, 0xfa4cf8f5d2aebcb8ULL,
+			0x7a1b6b28501f91b2ULL, 0xc5fdd38def281c31ULL,
+			0x05d61a632e708ab4ULL, 0xba30a2c691470737ULL,
+			0x71b75fee0cfe84daULL, 0xce51e74bb3c90959ULL,
+			0x0e7a2ea572919fdcULL, 0xb19c9600cda6125fULL,
+			0x31cb05dd4f173f55ULL, 0x8e2dbd78f020b2d6ULL,
+			0x4e06749631782453ULL, 0xf1e0cc338e4fa9d0ULL,
+			0x4ea9532d341a7e47ULL, 0xf14feb888b2df3c4ULL,
+			0x316422664a756541ULL, 0x8e829ac3f542e8c2ULL,
+			0x0ed5091e77f3c5c8ULL, 0xb133b1bbc8c4484bULL,
+			0x71187855099cdeceULL, 0xcefec0f0b6ab534dULL,
+			0x0f8b46687d3771e0ULL, 0xb06dfecdc200fc63ULL,
+			0x7046372303586ae6ULL, 0xcfa08f86bc6fe765ULL,
+			0x4ff71c5b3edeca6fULL, 0xf011a4fe81e947ecULL,
+			0x303a6d1040b1d169ULL, 0x8fdcd5b5ff865ceaULL,
+			0x30954aab45d38b7dULL, 0x8f73f20efae406feULL,
+			0x4f583be03bbc907bULL, 0xf0be8345848b1df8ULL,
+			0x70e91098063a30f2ULL, 0xcf0fa83db90dbd71ULL,
+			0x0f2461d378552bf4ULL, 0xb0c2d976c762a677ULL,
+			0x3229d447505ae32dULL, 0x8dcf6ce2ef6d6eaeULL,
+			0x4de4a50c2e35f82bULL, 0xf2021da9910275a8ULL,
+			0x72558e7413b358a2ULL, 0xcdb336d1ac84d521ULL,
+			0x0d98ff3f6ddc43a4ULL, 0xb27e479ad2ebce27ULL,
+			0x0d37d88468be19b0ULL, 0xb2d16021d7899433ULL,
+			0x72faa9cf16d102b6ULL, 0xcd1c116aa9e68f35ULL,
+			0x4d4b82b72b57a23fULL, 0xf2ad3a1294602fbcULL,
+			0x3286f3fc5538b939ULL, 0x8d604b59ea0f34baULL,
+			0x4c15cdc121931617ULL, 0xf3f375649ea49b94ULL,
+			0x33d8bc8a5ffc0d11ULL, 0x8c3e042fe0cb8092ULL,
+			0x0c6997f2627aad98ULL, 0xb38f2f57dd4d201bULL,
+			0x73a4e6b91c15b69eULL, 0xcc425e1ca3223b1dULL,
+			0x730bc1021977ec8aULL, 0xcced79a7a6406109ULL,
+			0x0cc6b0496718f78cULL, 0xb32008ecd82f7a0fULL,
+			0x33779b315a9e5705ULL, 0x8c912394e5a9da86ULL,
+			0x4cbaea7a24f14c03ULL, 0xf35c52df9bc6c180ULL,
+			0x496cf0190a81c6b7ULL, 0xf68a48bcb5b64b34ULL,
+			0x36a1815274eeddb1ULL, 0x894739f7cbd95032ULL,
+			0x0910aa2a49687d38ULL, 0xb6f6128ff65ff0bbULL,
+			0x76dddb613707663eULL, 0xc93b63c48830ebbdULL,
+			0x7672fcda32653c2aULL, 0xc994447f8d52b1a9ULL,
+			0x09bf8d914c0a272cULL, 0xb6593534f33daaafULL,
+			0x360ea6e9718c87a5ULL, 0x89e81e4ccebb0a26ULL,
+			0x49c3d7a20fe39ca3ULL, 0xf6256f07b0d41120ULL,
+			0x3750e99f7b48338dULL, 0x88b6513ac47fbe0eULL,
+			0x489d98d40527288bULL, 0xf77b2071ba10a508ULL,
+			0x772cb3ac38a18802ULL, 0xc8ca0b0987960581ULL,
+			0x08e1c2e746ce9304ULL, 0xb7077a42f9f91e87ULL,
+			0x084ee55c43acc910ULL, 0xb7a85df9fc9b4493ULL,
+			0x778394173dc3d216ULL, 0xc8652cb282f45f95ULL,
+			0x4832bf6f0045729fULL, 0xf7d407cabf72ff1cULL,
+			0x37ffce247e2a6999ULL, 0x88197681c11de41aULL,
+			0x0af27bb05625a140ULL, 0xb514c315e9122cc3ULL,
+			0x753f0afb284aba46ULL, 0xcad9b25e977d37c5ULL,
+			0x4a8e218315cc1acfULL, 0xf5689926aafb974cULL,
+			0x354350c86ba301c9ULL, 0x8aa5e86dd4948c4aULL,
+			0x35ec77736ec15bddULL, 0x8a0acfd6d1f6d65eULL,
+			0x4a21063810ae40dbULL, 0xf5c7be9daf99cd58ULL,
+			0x75902d402d28e052ULL, 0xca7695e5921f6dd1ULL,
+			0x0a5d5c0b5347fb54ULL, 0xb5bbe4aeec7076d7ULL,
+			0x74ce623627ec547aULL, 0xcb28da9398dbd9f9ULL,
+			0x0b03137d59834f7cULL, 0xb4e5abd8e6b4c2ffULL,
+			0x34b238056405eff5ULL, 0x8b5480a0db326276ULL,
+			0x4b7f494e1a6af4f3ULL, 0xf499f1eba55d7970ULL,
+			0x4bd06ef51f08aee7ULL, 0xf436d650a03f2364ULL,
+			0x341d1fbe6167b5e1ULL, 0x8bfba71bde503862ULL,
+			0x0bac34c65ce11568ULL, 0xb44a8c63e3d698ebULL,
+			0x7461458d228e0e6eULL, 0xcb87fd289db983edULL,
+		},
+		.U = {
+			0x0000000000000000ULL, 0x07e57e16164e3facULL,
+			0x0fcafc2c2c9c7f58ULL, 0x082f823a3ad240f4ULL,
+			0x1f95f8585938feb0ULL, 0x1870864e4f76c11cULL,
+			0x105f047475a481e8ULL, 0x17ba7a6263eabe44ULL,
+			0x3f2bf0b0b271fd60ULL, 0x38ce8ea6a43fc2ccULL,
+			0x30e10c9c9eed8238ULL, 0x3704728a88a3bd94ULL,
+			0x20be08e8eb4903d0ULL, 0x275b76fefd073c7cULL,
+			0x2f74f4c4c7d57c88ULL, 0x28918ad2d19b4324ULL,
+			0x7e57e16164e3fac0ULL, 0x79b29f7772adc56cULL,
+			0x719d1d4d487f8598ULL, 0x7678635b5e31ba34ULL,
+			0x61c219393ddb0470ULL, 0x6627672f2b953bdcULL,
+			0x6e08e51511477b28ULL, 0x69ed9b0307094484ULL,
+			0x417c11d1d69207a0ULL, 0x46996fc7c0dc380cULL,
+			0x4eb6edfdfa0e78f8ULL, 0x495393ebec404754ULL,
+			0x5ee9e9898faaf910ULL, 0x590c979f99e4c6bcULL,
+			0x512315a5a3368648ULL, 0x56c66bb3b578b9e4ULL,
+			0x43497a6776f07803ULL, 0x44ac047160be47afULL,
+			0x4c83864b5a6c075bULL, 0x4b66f85d4c2238f7ULL,
+			0x5cdc823f2fc886b3ULL, 0x5b39fc293986b91fULL,
+			0x53167e130354f9ebULL, 0x54f30005151ac647ULL,
+			0x7c628ad7c4818563ULL, 0x7b87f4c1d2cfbacfULL,
+			0x73a876fbe81dfa3bULL, 0x744d08edfe53c597ULL,
+			0x63f7728f9db97bd3ULL, 0x64120c998bf7447fULL,
+			0x6c3d8ea3b125048bULL, 0x6bd8f0b5a76b3b27ULL,
+			0x3d1e9b06121382c3ULL, 0x3afbe510045dbd6fULL,
+			0x32d4672a3e8ffd9bULL, 0x3531193c28c1c237ULL,
+			0x228b635e4b2b7c73ULL, 0x256e1d485d6543dfULL,
+			0x2d419f7267b7032bULL, 0x2aa4e16471f93c87ULL,
+			0x02356bb6a0627fa3ULL, 0x05d015a0b62c400fULL,
+			0x0dff979a8cfe00fbULL, 0x0a1ae98c9ab03f57ULL,
+			0x1da093eef95a8113ULL, 0x1a45edf8ef14bebfULL,
+			0x126a6fc2d5c6fe4bULL, 0x158f11d4c388c1e7ULL,
+			0x39744c6b52d77d85ULL, 0x3e91327d44994229ULL,
+			0x36beb0477e4b02ddULL, 0x315bce5168053d71ULL,
+			0x26e1b4330bef8335ULL, 0x2104ca251da1bc99ULL,
+			0x292b481f2773fc6dULL, 0x2ece3609313dc3c1ULL,
+			0x065fbcdbe0a680e5ULL, 0x01bac2cdf6e8bf49ULL,
+			0x099540f7cc3affbdULL, 0x0e703ee1da74c011ULL,
+			0x19ca4483b99e7e55ULL, 0x1e2f3a95afd041f9ULL,
+			0x1600b8af9502010dULL, 0x11e5c6b9834c3ea1ULL,
+			0x4723ad0a36348745ULL, 0x40c6d31c207ab8e9ULL,
+			0x48e951261aa8f81dULL, 0x4f0c2f300ce6c7b1ULL,
+			0x58b655526f0c79f5ULL, 0x5f532b4479424659ULL,
+			0x577ca97e439006adULL, 0x5099d76855de3901ULL,
+			0x78085dba84457a25ULL, 0x7fed23ac920b4589ULL,
+			0x77c2a196a8d9057dULL, 0x7027df80be973ad1ULL,
+			0x679da5e2dd7d8495ULL, 0x6078dbf4cb33bb39ULL,
+			0x685759cef1e1fbcdULL, 0x6fb227d8e7afc461ULL,
+			0x7a3d360c24270586ULL, 0x7dd8481a32693a2aULL,
+			0x75f7ca2008bb7adeULL, 0x7212b4361ef54572ULL,
+			0x65a8ce547d1ffb36ULL, 0x624db0426b51c49aULL,
+			0x6a6232785183846eULL, 0x6d874c6e47cdbbc2ULL,
+			0x4516c6bc9656f8e6ULL, 0x42f3b8aa8018c74aULL,
+			0x4adc3a90baca87beULL, 0x4d394486ac84b812ULL,
+			0x5a833ee4cf6e0656ULL, 0x5d6640f2d92039faULL,
+			0x5549c2c8e3f2790eULL, 0x52acbcdef5bc46a2ULL,
+			0x046ad76d40c4ff46ULL, 0x038fa97b568ac0eaULL,
+			0x0ba02b416c58801eULL, 0x0c4555577a16bfb2ULL,
+			0x1bff2f3519fc01f6ULL, 0x1c1a51230fb23e5aULL,
+			0x1435d31935607eaeULL, 0x13d0ad0f232e4102ULL,
+			0x3b4127ddf2b50226ULL, 0x3ca459cbe4fb3d8aULL,
+			0x348bdbf1de297d7eULL, 0x336ea5e7c86742d2ULL,
+			0x24d4df85ab8dfc96ULL, 0x2331a193bdc3c33aULL,
+			0x2b1e23a9871183ceULL, 0x2cfb5dbf915fbc62ULL,
+			0x72e898d6a5aefb0aULL, 0x750de6c0b3e0c4a6ULL,
+			0x7d2264fa89328452ULL, 0x7ac71aec9f7cbbfeULL,
+			0x6d7d608efc9605baULL, 0x6a981e98ead83a16ULL,
+			0x62b79ca2d00a7ae2ULL, 0x6552e2b4c644454eULL,
+			0x4dc3686617df066aULL, 0x4a261670019139c6ULL,
+			0x4209944a3b437932ULL, 0x45ecea5c2d0d469eULL,
+			0x5256903e4ee7f8daULL, 0x55b3ee2858a9c776ULL,
+			0x5d9c6c12627b8782ULL, 0x5a7912047435b82eULL,
+			0x0cbf79b7c14d01caULL, 0x0b5a07a1d7033e66ULL,
+			0x0375859bedd17e92ULL, 0x0490fb8dfb9f413eULL,
+			0x132a81ef9875ff7aULL, 0x14cffff98e3bc0d6ULL,
+			0x1ce07dc3b4e98022ULL, 0x1b0503d5a2a7bf8eULL,
+			0x33948907733cfcaaULL, 0x3471f7116572c306ULL,
+			0x3c5e752b5fa083f2ULL, 0x3bbb0b3d49eebc5eULL,
+			0x2c01715f2a04021aULL, 0x2be40f493c4a3db6ULL,
+			0x23cb8d7306987d42ULL, 0x242ef36510d642eeULL,
+			0x31a1e2b1d35e8309ULL, 0x36449ca7c510bca5ULL,
+			0x3e6b1e9dffc2fc51ULL, 0x398e608be98cc3fdULL,
+			0x2e341ae98a667db9ULL, 0x29d164ff9c284215ULL,
+			0x21fee6c5a6fa02e1ULL, 0x261b98d3b0b43d4dULL,
+			0x0e8a1201612f7e69ULL, 0x096f6c17776141c5ULL,
+			0x0140ee2d4db30131ULL, 0x06a5903b5bfd3e9dULL,
+			0x111fea59381780d9ULL, 0x16fa944f2e59bf75ULL,
+			0x1ed51675148bff81ULL, 0x1930686302c5c02dULL,
+			0x4ff603d0b7bd79c9ULL, 0x48137dc6a1f34665ULL,
+			0x403cfffc9b210691ULL, 0x47d981ea8d6f393dULL,
+			0x5063fb88ee858779ULL, 0x5786859ef8cbb8d5ULL,
+			0x5fa907a4c219f821ULL, 0x584c79b2d457c78dULL,
+			0x70ddf36005cc84a9ULL, 0x77388d761382bb05ULL,
+			0x7f170f4c2950fbf1ULL, 0x78f2715a3f1ec45dULL,
+			0x6f480b385cf47a19ULL, 0x68ad752e4aba45b5ULL,
+			0x6082f71470680541ULL, 0x6767890266263aedULL,
+			0x4b9cd4bdf779868fULL, 0x4c79aaabe137b923ULL,
+			0x44562891dbe5f9d7ULL, 0x43b35687cdabc67bULL,
+			0x54092ce5ae41783fULL, 0x53ec52f3b80f4793ULL,
+			0x5bc3d0c982dd0767ULL, 0x5c26aedf949338cbULL,
+			0x74b7240d45087befULL, 0x73525a1b53464443ULL,
+			0x7b7dd821699404b7ULL, 0x7c98a6377fda3b1bULL,
+			0x6b22dc551c30855fULL, 0x6cc7a2430a7ebaf3ULL,
+			0x64e8207930acfa07ULL, 0x630d5e6f26e2c5abULL,
+			0x35cb35dc939a7c4fULL, 0x322e4bca85d443e3ULL,
+			0x3a01c9f0bf060317ULL, 0x3de4b7e6a9483cbbULL,
+			0x2a5ecd84caa282ffULL, 0x2dbbb392dcecbd53ULL,
+			0x259431a8e63efda7ULL, 0x22714fbef070c20bULL,
+			0x0ae0c56c21eb812fULL, 0x0d05bb7a37a5be83ULL,
+			0x052a39400d77fe77ULL, 0x02cf47561b39c1dbULL,
+			0x15753d3478d37f9fULL, 0x129043226e9d4033ULL,
+			0x1abfc118544f00c7ULL, 0x1d5abf0e42013f6bULL,
+			0x08d5aeda8189fe8cULL, 0x0f30d0cc97c7c120ULL,
+			0x071f52f6ad1581d4ULL, 0x00fa2ce0bb5bbe78ULL,
+			0x17405682d8b1003cULL, 0x10a52894ceff3f90ULL,
+			0x188aaaaef42d7f64ULL, 0x1f6fd4b8e26340c8ULL,
+			0x37fe5e6a33f803ecULL, 0x301b207c25b63c40ULL,
+			0x3834a2461f647cb4ULL, 0x3fd1dc50092a4318ULL,
+			0x286ba6326ac0fd5cULL, 0x2f8ed8247c8ec2f0ULL,
+			0x27a15a1e465c8204ULL, 0x204424085012bda8ULL,
+			0x76824fbbe56a044cULL, 0x716731adf3243be0ULL,
+			0x7948b397c9f67b14ULL, 0x7eadcd81dfb844b8ULL,
+			0x6917b7e3bc52fafcULL, 0x6ef2c9f5aa1cc550ULL,
+			0x66dd4bcf90ce85a4ULL, 0x613835d98680ba08ULL,
+			0x49a9bf0b571bf92cULL, 0x4e4cc11d4155c680ULL,
+			0x466343277b878674ULL, 0x41863d316dc9b9d8ULL,
+			0x563c47530e23079cULL, 0x51d93945186d3830ULL,
+			0x59f6bb7f22bf78c4ULL, 0x5e13c56934f14768ULL,
+		},
+	},
+	{
+		.poly = 0x3f63dfbf84af3bULL,
+		.window_size = 32,
+		.shift = 45,
+		.T = {
+			0x0000000000000000ULL, 0x003f63dfbf84af3bULL,
+			0x0041a460c08df14dULL, 0x007ec7bf7f095e76ULL,
+			0x008348c1811be29aULL, 0x00bc2b1e3e9f4da1ULL,
+			0x00c2eca1419613d7ULL, 0x00fd8f7efe12bcecULL,
+			0x010691830237c534ULL, 0x0139f25cbdb36a0fULL,
+			0x014735e3c2ba3479ULL, 0x0178563c7d3e9b42ULL,
+			0x0185d942832c27aeULL, 0x01baba9d3ca88895ULL,
+			0x01c47d2243a1d6e3ULL, 0x01fb1efdfc2579d8ULL,
+			0x020d2306046f8a68ULL, 0x023240d9bbeb2553ULL,
+			0x024c8766c4e27b25ULL, 0x0273e4b97b66d41eULL,
+			0x028e6bc7857468f2ULL, 0x02b108183af0c7c9ULL,
+			0x02cfcfa745f999bfULL, 0x02f0ac78fa7d3684ULL,
+			0x030bb28506584f5cULL, 0x0334d15ab9dce067ULL,
+			0x034a16e5c6d5be11ULL, 0x0375753a7951112aULL,
+			0x0388fa448743adc6ULL, 0x03b7999b38c702fdULL,
+			0x03c95e2447ce5c8bULL, 0x03f63dfbf84af3b0ULL,
+			0x041a460c08df14d0ULL, 0x042525d3b75bbbebULL,
+			0x045be26cc852e59dULL, 0x046481b377d64aa6ULL,
+			0x04990ecd89c4f64aULL, 0x04a66d1236405971ULL,
+			0x04d8aaad49490707ULL, 0x04e7c972f6cda83cULL,
+			0x051cd78f0ae8d1e4ULL, 0x0523b450b56c7edfULL,
+			0x055d73efca6520a9ULL, 0x0562103075e18f92ULL,
+			0x059f9f4e8bf3337eULL, 0x05a0fc9134779c45ULL,
+			0x05de3b2e4b7ec233ULL, 0x05e158f1f4fa6d08ULL,
+			0x0617650a0cb09eb8ULL, 0x062806d5b3343183ULL,
+			0x0656c16acc3d6ff5ULL, 0x0669a2b573b9c0ceULL,
+			0x06942dcb8dab7c22ULL, 0x06ab4e14322fd319ULL,
+			0x06d589ab4d268d6fULL, 0x06eaea74f2a22254ULL,
+			0x0711f4890e875b8cULL, 0x072e9756b103f4b7ULL,
+			0x075050e9ce0aaac1ULL, 0x076f3336718e05faULL,
+			0x0792bc488f9cb916ULL, 0x07addf973018162dULL,
+			0x07d318284f11485bULL, 0x07ec7bf7f095e760ULL,
+			0x080befc7ae3a869bULL, 0x08348c1811be29a0ULL,
+			0x084a4ba76eb777d6ULL, 0x08752878d133d8edULL,
+			0x0888a7062f216401ULL, 0x08b7c4d990a5cb3aULL,
+			0x08c90366efac954cULL, 0x08f660b950283a77ULL,
+			0x090d7e44ac0d43afULL, 0x09321d9b1389ec94ULL,
+			0x094cda246c80b2e2ULL, 0x0973b9fbd3041dd9ULL,
+			0x098e36852d16a135ULL, 0x09b1555a92920e0eULL,
+			0x09cf92e5ed9b5078ULL, 0x09f0f13a521fff43ULL,
+			0x0a06ccc1aa550cf3ULL, 0x0a39af1e15d1a3c8ULL,
+			0x0a4768a16ad8fdbeULL, 0x0a780b7ed55c5285ULL,
+			0x0a8584002b4eee69ULL, 0x0abae7df94ca4152ULL,
+			0x0ac42060ebc31f24ULL, 0x0afb43bf5447b01fULL,
+			0x0b005d42a862c9c7ULL, 0x0b3f3e9d17e666fcULL,
+			0x0b41f92268ef388aULL, 0x0b7e9afdd76b97b1ULL,
+			0x0b83158329792b5dULL, 0x0bbc765c96fd8466ULL,
+			0x0bc2b1e3e9f4da10ULL, 0x0bfdd23c5670752bULL,
+			0x0c11a9cba6e5924bULL, 0x0c2eca1419613d70ULL,
+			0x0c500dab66686306ULL, 0x0c6f6e74d9eccc3dULL,
+			0x0c92e10a27fe70d1ULL, 0x0cad82d5987adfeaULL,
+			0x0cd3456ae773819cULL, 0x0cec26b558f72ea7ULL,
+			0x0d173848a4d2577fULL, 0x0d285b971b56f844ULL,
+			0x0d569c28645fa632ULL, 0x0d69fff7dbdb0909ULL,
+			0x0d94708925c9b5e5ULL, 0x0dab13569a4d1adeULL,
+			0x0dd5d4e9e54444a8ULL, 0x0deab7365ac0eb93ULL,
+			0x0e1c8acda28a1823ULL, 0x0e23e9121d0eb718ULL,
+			0x0e5d2ead6207e96eULL, 0x0e624d72dd834655ULL,
+			0x0e9fc20c2391fab9ULL, 0x0ea0a1d39c155582ULL,
+			0x0ede666ce31c0bf4ULL, 0x0ee105b35c98a4cfULL,
+			0x0f1a1b4ea0bddd17ULL, 0x0f2578911f39722cULL,
+			0x0f5bbf2e60302c5aULL, 0x0f64dcf1dfb48361ULL,
+			0x0f99538f21a63f8dULL, 0x0fa630509e2290b6ULL,
+			0x0fd8f7efe12bcec0ULL, 0x0fe794305eaf61fbULL,
+			0x1017df8f5c750d36ULL, 0x1028bc50e3f1a20dULL,
+			0x10567bef9cf8fc7bULL, 0x10691830237c5340ULL,
+			0x1094974edd6eefacULL, 0x10abf49162ea4097ULL,
+			0x10d5332e1de31ee1ULL, 0x10ea50f1a267b1daULL,
+			0x11114e0c5e42c802ULL, 0x112e2dd3e1c66739ULL,
+			0x1150ea6c9ecf394fULL, 0x116f89b3214b9674ULL,
+			0x119206cddf592a98ULL, 0x11ad651260dd85a3ULL,
+			0x11d3a2ad1fd4dbd5ULL, 0x11ecc172a05074eeULL,
+			0x121afc89581a875eULL, 0x12259f56e79e2865ULL,
+			0x125b58e998977613ULL, 0x12643b362713d928ULL,
+			0x1299b448d90165c4ULL, 0x12a6d7976685caffULL,
+			0x12d81028198c9489ULL, 0x12e773f7a6083bb2ULL,
+			0x131c6d0a5a2d426aULL, 0x13230ed5e5a9ed51ULL,
+			0x135dc96a9aa0b327ULL, 0x1362aab525241c1cULL,
+			0x139f25cbdb36a0f0ULL, 0x13a0461464b20fcbULL,
+			0x13de81ab1bbb51bdULL, 0x13e1e274a43ffe86ULL,
+			0x140d998354aa19e6ULL, 0x1432fa5ceb2eb6ddULL,
+			0x144c3de39427e8abULL, 0x14735e3c2ba34790ULL,
+			0x148ed142d5b1fb7cULL, 0x14b1b29d6a355447ULL,
+			0x14cf7522153c0a31ULL, 0x14f016fdaab8a50aULL,
+			0x150b0800569ddcd2ULL, 0x15346bdfe91973e9ULL,
+			0x154aac6096102d9fULL, 0x1575cfbf299482a4ULL,
+			0x158840c1d7863e48ULL, 0x15b7231e68029173ULL,
+			0x15c9e4a1170bcf05ULL, 0x15f6877ea88f603eULL,
+			0x1600ba8550c5938eULL, 0x163fd95aef413cb5ULL,
+			0x16411ee5904862c3ULL, 0x167e7d3a2fcccdf8ULL,
+			0x1683f244d1de7114ULL, 0x16bc919b6e5ade2fULL,
+			0x16c2562411538059ULL, 0x16fd35fbaed72f62ULL,
+			0x17062b0652f256baULL, 0x173948d9ed76f981ULL,
+			0x17478f66927fa7f7ULL, 0x1778ecb92dfb08ccULL,
+			0x178563c7d3e9b420ULL, 0x17ba00186c6d1b1bULL,
+			0x17c4c7a71364456dULL, 0x17fba478ace0ea56ULL,
+			0x181c3048f24f8badULL, 0x182353974dcb2496ULL,
+			0x185d942832c27ae0ULL, 0x1862f7f78d46d5dbULL,
+			0x189f788973546937ULL, 0x18a01b56ccd0c60cULL,
+			0x18dedce9b3d9987aULL, 0x18e1bf360c5d3741ULL,
+			0x191aa1cbf0784e99ULL, 0x1925c2144ffce1a2ULL,
+			0x195b05ab30f5bfd4ULL, 0x196466748f7110efULL,
+			0x1999e90a7163ac03ULL, 0x19a68ad5cee70338ULL,
+			0x19d84d6ab1ee5d4eULL, 0x19e72eb50e6af275ULL,
+			0x1a11134ef62001c5ULL, 0x1a2e709149a4aefeULL,
+			0x1a50b72e36adf088ULL, 0x1a6fd4f189295fb3ULL,
+			0x1a925b8f773be35fULL, 0x1aad3850c8bf4c64ULL,
+			0x1ad3ffefb7b61212ULL, 0x1aec9c300832bd29ULL,
+			0x1b1782cdf417c4f1ULL, 0x1b28e1124b936bcaULL,
+			0x1b5626ad349a35bcULL, 0x1b6945728b1e9a87ULL,
+			0x1b94ca0c750c266bULL, 0x1baba9d3ca888950ULL,
+			0x1bd56e6cb581d726ULL, 0x1bea0db30a05781dULL,
+			0x1c067644fa909f7dULL, 0x1c39159b45143046ULL,
+			0x1c47d2243a1d6e30ULL, 0x1c78b1fb8599c10bULL,
+			0x1c853e857b8b7de7ULL, 0x1cba5d5ac40fd2dcULL,
+			0x1cc49ae5bb068caaULL, 0x1cfbf93a04822391ULL,
+			0x1d00e7c7f8a75a49ULL, 0x1d3f84184723f572ULL,
+			0x1d4143a7382aab04ULL, 0x1d7e207887ae043fULL,
+			0x1d83af0679bcb8d3ULL, 0x1dbcccd9c63817e8ULL,
+			0x1dc20b66b931499eULL, 0x1dfd68b906b5e6a5ULL,
+			0x1e0b5542feff1515ULL, 0x1e34369d417bba2eULL,
+			0x1e4af1223e72e458ULL, 0x1e7592fd81f64b63ULL,
+			0x1e881d837fe4f78fULL, 0x1eb77e5cc06058b4ULL,
+			0x1ec9b9e3bf6906c2ULL, 0x1ef6da3c00eda9f9ULL,
+			0x1f0dc4c1fcc8d021ULL, 0x1f32a71e434c7f1aULL,
+			0x1f4c60a13c45216cULL, 0x1f73037e83c18e57ULL,
+			0x1f8e8c007dd332bbULL, 0x1fb1efdfc2579d80ULL,
+			0x1fcf2860bd5ec3f6ULL, 0x1ff04bbf02da6ccdULL,
+		},
+		.U = {
+			0x0000000000000000ULL, 0x00053605fa0d4db9ULL,
+			0x000a6c0bf41a9b72ULL, 0x000f5a0e0e17d6cbULL,
+			0x0014d817e83536e4ULL, 0x0011ee1212387b5dULL,
+			0x001eb41c1c2fad96ULL, 0x001b8219e622e02fULL,
+			0x0016d3f06feec2f3ULL, 0x0013e5f595e38f4aULL,
+			0x001cbffb9bf45981ULL, 0x001989fe61f91438ULL,
+			0x00020be787dbf417ULL, 0x00073de27dd6b9aeULL,
+			0x000867ec73c16f65ULL, 0x000d51e989cc22dcULL,
+			0x0012c43f60592addULL, 0x0017f23a9a546764ULL,
+			0x0018a8349443b1afULL, 0x001d9e316e4efc16ULL,
+			0x00061c28886c1c39ULL, 0x00032a2d72615180ULL,
+			0x000c70237c76874bULL, 0x00094626867bcaf2ULL,
+			0x000417cf0fb7e82eULL, 0x000121caf5baa597ULL,
+			0x000e7bc4fbad735cULL, 0x000b4dc101a03ee5ULL,
+			0x0010cfd8e782decaULL, 0x0015f9dd1d8f9373ULL,
+			0x001aa3d3139845b8ULL, 0x001f95d6e9950801ULL,
+			0x001aeba17f36fa81ULL, 0x001fdda4853bb738ULL,
+			0x001087aa8b2c61f3ULL, 0x0015b1af71212c4aULL,
+			0x000e33b69703cc65ULL, 0x000b05b36d0e81dcULL,
+			0x00045fbd63195717ULL, 0x000169b899141aaeULL,
+			0x000c385110d83872ULL, 0x00090e54ead575cbULL,
+			0x0006545ae4c2a300ULL, 0x0003625f1ecfeeb9ULL,
+			0x0018e046f8ed0e96ULL, 0x001dd64302e0432fULL,
+			0x00128c4d0cf795e4ULL, 0x0017ba48f6fad85dULL,
+			0x00082f9e1f6fd05cULL, 0x000d199be5629de5ULL,
+			0x00024395eb754b2eULL, 0x0007759011780697ULL,
+			0x001cf789f75ae6b8ULL, 0x0019c18c0d57ab01ULL,
+			0x00169b8203407dcaULL, 0x0013ad87f94d3073ULL,
+			0x001efc6e708112afULL, 0x001bca6b8a8c5f16ULL,
+			0x00149065849b89ddULL, 0x0011a6607e96c464ULL,
+			0x000a247998b4244bULL, 0x000f127c62b969f2ULL,
+			0x000048726caebf39ULL, 0x00057e7796a3f280ULL,
+			0x000ab49d41e95a39ULL, 0x000f8298bbe41780ULL,
+			0x0000d896b5f3c14bULL, 0x0005ee934ffe8cf2ULL,
+			0x001e6c8aa9dc6cddULL, 0x001b5a8f53d12164ULL,
+			0x001400815dc6f7afULL, 0x00113684a7cbba16ULL,
+			0x001c676d2e0798caULL, 0x00195168d40ad573ULL,
+			0x00160b66da1d03b8ULL, 0x00133d6320104e01ULL,
+			0x0008bf7ac632ae2eULL, 0x000d897f3c3fe397ULL,
+			0x0002d3713228355cULL, 0x0007e574c82578e5ULL,
+			0x001870a221b070e4ULL, 0x001d46a7dbbd3d5dULL,
+			0x00121ca9d5aaeb96ULL, 0x00172aac2fa7a62fULL,
+			0x000ca8b5c9854600ULL, 0x00099eb033880bb9ULL,
+			0x0006c4be3d9fdd72ULL, 0x0003f2bbc79290cbULL,
+			0x000ea3524e5eb217ULL, 0x000b9557b453ffaeULL,
+			0x0004cf59ba442965ULL, 0x0001f95c404964dcULL,
+			0x001a7b45a66b84f3ULL, 0x001f4d405c66c94aULL,
+			0x0010174e52711f81ULL, 0x0015214ba87c5238ULL,
+			0x00105f3c3edfa0b8ULL, 0x00156939c4d2ed01ULL,
+			0x001a3337cac53bcaULL, 0x001f053230c87673ULL,
+			0x0004872bd6ea965cULL, 0x0001b12e2ce7dbe5ULL,
+			0x000eeb2022f00d2eULL, 0x000bdd25d8fd4097ULL,
+			0x00068ccc5131624bULL, 0x0003bac9ab3c2ff2ULL,
+			0x000ce0c7a52bf939ULL, 0x0009d6c25f26b480ULL,
+			0x001254dbb90454afULL, 0x001762de43091916ULL,
+			0x001838d04d1ecfddULL, 0x001d0ed5b7138264ULL,
+			0x00029b035e868a65ULL, 0x0007ad06a48bc7dcULL,
+			0x0008f708aa9c1117ULL, 0x000dc10d50915caeULL,
+			0x00164314b6b3bc81ULL, 0x001375114cbef138ULL,
+			0x001c2f1f42a927f3ULL, 0x0019191ab8a46a4aULL,
+			0x001448f331684896ULL, 0x00117ef6cb65052fULL,
+			0x001e24f8c572d3e4ULL, 0x001b12fd3f7f9e5dULL,
+			0x000090e4d95d7e72ULL, 0x0005a6e1235033cbULL,
+			0x000afcef2d47e500ULL, 0x000fcaead74aa8b9ULL,
+			0x0015693a83d2b472ULL, 0x00105f3f79dff9cbULL,
+			0x001f053177c82f00ULL, 0x001a33348dc562b9ULL,
+			0x0001b12d6be78296ULL, 0x0004872891eacf2fULL,
+			0x000bdd269ffd19e4ULL, 0x000eeb2365f0545dULL,
+			0x0003bacaec3c7681ULL, 0x00068ccf16313b38ULL,
+			0x0009d6c11826edf3ULL, 0x000ce0c4e22ba04aULL,
+			0x001762dd04094065ULL, 0x001254d8fe040ddcULL,
+			0x001d0ed6f013db17ULL, 0x001838d30a1e96aeULL,
+			0x0007ad05e38b9eafULL, 0x00029b001986d316ULL,
+			0x000dc10e179105ddULL, 0x0008f70bed9c4864ULL,
+			0x001375120bbea84bULL, 0x00164317f1b3e5f2ULL,
+			0x00191919ffa43339ULL, 0x001c2f1c05a97e80ULL,
+			0x00117ef58c655c5cULL, 0x001448f0766811e5ULL,
+			0x001b12fe787fc72eULL, 0x001e24fb82728a97ULL,
+			0x0005a6e264506ab8ULL, 0x000090e79e5d2701ULL,
+			0x000fcae9904af1caULL, 0x000afcec6a47bc73ULL,
+			0x000f829bfce44ef3ULL, 0x000ab49e06e9034aULL,
+			0x0005ee9008fed581ULL, 0x0000d895f2f39838ULL,
+			0x001b5a8c14d17817ULL, 0x001e6c89eedc35aeULL,
+			0x00113687e0cbe365ULL, 0x001400821ac6aedcULL,
+			0x0019516b930a8c00ULL, 0x001c676e6907c1b9ULL,
+			0x00133d6067101772ULL, 0x00160b659d1d5acbULL,
+			0x000d897c7b3fbae4ULL, 0x0008bf798132f75dULL,
+			0x0007e5778f252196ULL, 0x0002d37275286c2fULL,
+			0x001d46a49cbd642eULL, 0x001870a166b02997ULL,
+			0x00172aaf68a7ff5cULL, 0x00121caa92aab2e5ULL,
+			0x00099eb3748852caULL, 0x000ca8b68e851f73ULL,
+			0x0003f2b88092c9b8ULL, 0x0006c4bd7a9f8401ULL,
+			0x000b9554f353a6ddULL, 0x000ea351095eeb64ULL,
+			0x0001f95f07493dafULL, 0x0004cf5afd447016ULL,
+			0x001f4d431b669039ULL, 0x001a7b46e16bdd80ULL,
+			0x00152148ef7c0b4bULL, 0x0010174d157146f2ULL,
+			0x001fdda7c23bee4bULL, 0x001aeba23836a3f2ULL,
+			0x0015b1ac36217539ULL, 0x001087a9cc2c3880ULL,
+			0x000b05b02a0ed8afULL, 0x000e33b5d0039516ULL,
+			0x000169bbde1443ddULL, 0x00045fbe24190e64ULL,
+			0x00090e57add52cb8ULL, 0x000c385257d86101ULL,
+			0x0003625c59cfb7caULL, 0x00065459a3c2fa73ULL,
+			0x001dd64045e01a5cULL, 0x0018e045bfed57e5ULL,
+			0x0017ba4bb1fa812eULL, 0x00128c4e4bf7cc97ULL,
+			0x000d1998a262c496ULL, 0x00082f9d586f892fULL,
+			0x0007759356785fe4ULL, 0x00024396ac75125dULL,
+			0x0019c18f4a57f272ULL, 0x001cf78ab05abfcbULL,
+			0x0013ad84be4d6900ULL, 0x00169b81444024b9ULL,
+			0x001bca68cd8c0665ULL, 0x001efc6d37814bdcULL,
+			0x0011a66339969d17ULL, 0x00149066c39bd0aeULL,
+			0x000f127f25b93081ULL, 0x000a247adfb47d38ULL,
+			0x00057e74d1a3abf3ULL, 0x000048712baee64aULL,
+			0x00053606bd0d14caULL, 0x0000000347005973ULL,
+			0x000f5a0d49178fb8ULL, 0x000a6c08b31ac201ULL,
+			0x0011ee115538222eULL, 0x0014d814af356f97ULL,
+			0x001b821aa122b95cULL, 0x001eb41f5b2ff4e5ULL,
+			0x0013e5f6d2e3d639ULL, 0x0016d3f328ee9b80ULL,
+			0x001989fd26f94d4bULL, 0x001cbff8dcf400f2ULL,
+			0x00073de13ad6e0ddULL, 0x00020be4c0dbad64ULL,
+			0x000d51eacecc7bafULL, 0x000867ef34c13616ULL,
+			0x0017f239dd543e17ULL, 0x0012c43c275973aeULL,
+			0x001d9e32294ea565ULL, 0x0018a837d343e8dcULL,
+			0x00032a2e356108f3ULL, 0x00061c2bcf6c454aULL,
+			0x00094625c17b9381ULL, 0x000c70203b76de38ULL,
+			0x000121c9b2bafce4ULL, 0x000417cc48b7b15dULL,
+			0x000b4dc246a06796ULL, 0x000e7bc7bcad2a2fULL,
+			0x0015f9de5a8fca00ULL, 0x0010cfdba08287b9ULL,
+			0x001f95d5ae955172ULL, 0x001aa3d054981ccbULL,
+		},
+	},
+	{
+		.poly = 0x3f63dfbf84af3bULL,
+		.window_size = 512,
+		.shift = 45,
+		.T = {
+			0x0000000000000000ULL, 0x003f63dfbf84af3bULL,
+			0x0041a460c08df14dULL, 0x007ec7bf7f095e76ULL,
+			0x008348c1811be29aULL, 0x00bc2b1e3e9f4da1ULL,
+			0x00c2eca1419613d7ULL, 0x00fd8f7efe12bcecULL,
+			0x010691830237c534ULL, 0x0139f25cbdb36a0fULL,
+			0x014735e3c2ba3479ULL, 0x0178563c7d3e9b42ULL,
+			0x0185d942832c27aeULL, 0x01baba9d3ca88895ULL,
+			0x01c47d2243a1d6e3ULL, 0x01fb1efdfc2579d8ULL,
+			0x020d2306046f8a68ULL, 0x023240d9bbeb2553ULL,
+			0x024c8766c4e27b25ULL, 0x0273e4b97b66d41eULL,
+			0x028e6bc7857468f2ULL, 0x02b108183af0c7c9ULL,
+			0x02cfcfa745f999bfULL, 0x02f0ac78fa7d3684ULL,
+			0x030bb28506584f5cULL, 0x0334d15ab9dce067ULL,
+			0x034a16e5c6d5be11ULL, 0x0375753a7951112aULL,
+			0x0388fa448743adc6ULL, 0x03b7999b38c702fdULL,
+			0x03c95e2447ce5c8bULL, 0x03f63dfbf84af3b0ULL,
+			0x041a460c08df14d0ULL, 0x042525d3b75bbbebULL,
+			0x045be26cc852e59dULL, 0x046481b377d64aa6ULL,
+			0x04990ecd89c4f64aULL, 0x04a66d1236405971ULL,
+			0x04d8aaad49490707ULL, 0x04e7c972f6cda83cULL,
+			0x051cd78f0ae8d1e4ULL, 0x0523b450b56c7edfULL,
+			0x055d73efca6520a9ULL, 0x0562103075e18f92ULL,
+			0x059f9f4e8bf3337eULL, 0x05a0fc9134779c45ULL,
+			0x05de3b2e4b7ec233ULL, 0x05e158f1f4fa6d08ULL,
+			0x0617650a0cb09eb8ULL, 0x062806d5b3343183ULL,
+			0x0656c16acc3d6ff5ULL, 0x0669a2b573b9c0ceULL,
+			0x06942dcb8dab7c22ULL, 0x06ab4e14322fd319ULL,
+			0x06d589ab4d268d6fULL, 0x06eaea74f2a22254ULL,
+			0x0711f4890e875b8cULL, 0x072e9756b103f4b7ULL,
+			0x075050e9ce0aaac1ULL, 0x076f3336718e05faULL,
+			0x0792bc488f9cb916ULL, 0x07addf973018162dULL,
+			0x07d318284f11485bULL, 0x07ec7bf7f095e760ULL,
+			0x080befc7ae3a869bULL, 0x08348c1811be29a0ULL,
+			0x084a4ba76eb777d6ULL, 0x08752878d133d8edULL,
+			0x0888a7062f216401ULL, 0x08b7c4d990a5cb3aULL,
+			0x08c90366efac954cULL, 0x08f660b950283a77ULL,
+			0x090d7e44ac0d43afULL, 0x09321d9b1389ec94ULL,
+			0x094cda246c80b2e2ULL, 0x0973b9fbd3041dd9ULL,
+			0x098e36852d16a135ULL, 0x09b1555a92920e0eULL,
+			0x09cf92e5ed9b5078ULL, 0x09f0f13a521fff43ULL,
+			0x0a06ccc1aa550cf3ULL, 0x0a39af1e15d1a3c8ULL,
+			0x0a4768a16ad8fdbeULL, 0x0a780b7ed55c5285ULL,
+			0x0a8584002b4eee69ULL, 0x0abae7df94ca4152ULL,
+			0x0ac42060ebc31f24ULL, 0x0afb43bf5447b01fULL,
+			0x0b005d42a862c9c7ULL, 0x0b3f3e9d17e666fcULL,
+			0x0b41f92268ef388aULL, 0x0b7e9afdd76b97b1ULL,
+			0x0b83158329792b5dULL, 0x0bbc765c96fd8466ULL,
+			0x0bc2b1e3e9f4da10ULL, 0x0bfdd23c5670752bULL,
+			0x0c11a9cba6e5924bULL, 0x0c2eca1419613d70ULL,
+			0x0c500dab66686306ULL, 0x0c6f6e74d9eccc3dULL,
+			0x0c92e10a27fe70d1ULL, 0x0cad82d5987adfeaULL,
+			0x0cd3456ae773819cULL, 0x0cec26b558f72ea7ULL,
+			0x0d173848a4d2577fULL, 0x0d285b971b56f844ULL,
+			0x0d569c28645fa632ULL, 0x0d69fff7dbdb0909ULL,
+			0x0d94708925c9b5e5ULL, 0x0dab13569a4d1adeULL,
+			0x0dd5d4e9e54444a8ULL, 0x0deab7365ac0eb93ULL,
+			0x0e1c8acda28a1823ULL, 0x0e23e9121d0eb718ULL,
+			0x0e5d2ead6207e96eULL, 0x0e624d72dd834655ULL,
+			0x0e9fc20c2391fab9ULL, 0x0ea0a1d39c155582ULL,
+			0x0ede666ce31c0bf4ULL, 0x0ee105b35c98a4cfULL,
+			0x0f1a1b4ea0bddd17ULL, 0x0f2578911f39722cULL,
+			0x0f5bbf2e60302c5aULL, 0x0f64dcf1dfb48361ULL,
+			0x0f99538f21a63f8dULL, 0x0fa630509e2290b6ULL,
+			0x0fd8f7efe12bcec0ULL, 0x0fe794305eaf61fbULL,
+			0x1017df8f5c750d36ULL, 0x1028bc50e3f1a20dULL,
+			0x10567bef9cf8fc7bULL, 0x10691830237c5340ULL,
+			0x1094974edd6eefacULL, 0x10abf49162ea4097ULL,
+			0x10d5332e1de31ee1ULL, 0x10ea50f1a267b1daULL,
+			0x11114e0c5e42c802ULL, 0x112e2dd3e1c66739ULL,
+			0x1150ea6c9ecf394fULL, 0x116f89b3214b9674ULL,
+			0x119206cddf592a98ULL, 0x11ad651260dd85a3ULL,
+			0x11d3a2ad1fd4dbd5ULL, 0x11ecc172a05074eeULL,
+			0x121afc89581a875eULL, 0x12259f56e79e2865ULL,
+			0x125b58e998977613ULL, 0x12643b362713d928ULL,
+			0x1299b448d90165c4ULL, 0x12a6d7976685caffULL,
+			0x12d81028198c9489ULL, 0x12e773f7a6083bb2ULL,
+			0x131c6d0a5a2d426aULL, 0x13230ed5e5a9ed51ULL,
+			0x135dc96a9aa0b327ULL, 0x1362aab525241c1cULL,
+			0x139f25cbdb36a0f0ULL, 0x13a0461464b20fcbULL,
+			0x13de81ab1bbb51bdULL, 0x13e1e274a43ffe86ULL,
+			0x140d998354aa19e6ULL, 0x1432fa5ceb2eb6ddULL,
+			0x144c3de39427e8abULL, 0x14735e3c2ba34790ULL,
+			0x148ed142d5b1fb7cULL, 0x14b1b29d6a355447ULL,
+			0x14cf7522153c0a31ULL, 0x14f016fdaab8a50aULL,
+			0x150b0800569ddcd2ULL, 0x15346bdfe91973e9ULL,
+			0x154aac6096102d9fULL, 0x1575cfbf299482a4ULL,
+			0x158840c1d7863e48ULL, 0x15b7231e68029173ULL,
+			0x15c9e4a1170bcf05ULL, 0x15f6877ea88f603eULL,
+			0x1600ba8550c5938eULL, 0x163fd95aef413cb5ULL,
+			0x16411ee5904862c3ULL, 0x167e7d3a2fcccdf8ULL,
+			0x1683f244d1de7114ULL, 0x16bc919b6e5ade2fULL,
+			0x16c2562411538059ULL, 0x16fd35fbaed72f62ULL,
+			0x17062b0652f256baULL, 0x173948d9ed76f981ULL,
+			0x17478f66927fa7f7ULL, 0x1778ecb92dfb08ccULL,
+			0x178563c7d3e9b420ULL, 0x17ba00186c6d1b1bULL,
+			0x17c4c7a71364456dULL, 0x17fba478ace0ea56ULL,
+			0x181c3048f24f8badULL, 0x182353974dcb2496ULL,
+			0x185d942832c27ae0ULL, 0x1862f7f78d46d5dbULL,
+			0x189f788973546937ULL, 0x18a01b56ccd0c60cULL,
+			0x18dedce9b3d9987aULL, 0x18e1bf360c5d3741ULL,
+			0x191aa1cbf0784e99ULL, 0x1925c2144ffce1a2ULL,
+			0x195b05ab30f5bfd4ULL, 0x196466748f7110efULL,
+			0x1999e90a7163ac03ULL, 0x19a68ad5cee70338ULL,
+			0x19d84d6ab1ee5d4eULL, 0x19e72eb50e6af275ULL,
+			0x1a11134ef62001c5ULL, 0x1a2e709149a4aefeULL,
+			0x1a50b72e36adf088ULL, 0x1a6fd4f189295fb3ULL,
+			0x1a925b8f773be35fULL, 0x1aad3850c8bf4c64ULL,
+			0x1ad3ffefb7b61212ULL, 0x1aec9c300832bd29ULL,
+			0x1b1782cdf417c4f1ULL, 0x1b28e1124b936bcaULL,
+			0x1b5626ad349a35bcULL, 0x1b6945728b1e9a87ULL,
+			0x1b94ca0c750c266bULL, 0x1baba9d3ca888950ULL,
+			0x1bd56e6cb581d726ULL, 0x1bea0db30a05781dULL,
+			0x1c067644fa909f7dULL, 0x1c39159b45143046ULL,
+			0x1c47d2243a1d6e30ULL, 0x1c78b1fb8599c10bULL,
+			0x1c853e857b8b7de7ULL, 0x1cba5d5ac40fd2dcULL,
+			0x1cc49ae5bb068caaULL, 0x1cfbf93a04822391ULL,
+			0x1d00e7c7f8a75a49ULL, 0x1d3f84184723f572ULL,
+			0x1d4143a7382aab04ULL, 0x1d7e207887ae043fULL,
+			0x1d83af0679bcb8d3ULL, 0x1dbcccd9c63817e8ULL,
+			0x1dc20b66b931499eULL, 0x1dfd68b906b5e6a5ULL,
+			0x1e0b5542feff1515ULL, 0x1e34369d417bba2eULL,
+			0x1e4af1223e72e458ULL, 0x1e7592fd81f64b63ULL,
+			0x1e881d837fe4f78fULL, 0x1eb77e5cc06058b4ULL,
+			0x1ec9b9e3bf6906c2ULL, 0x1ef6da3c00eda9f9ULL,
+			0x1f0dc4c1fcc8d021ULL, 0x1f32a71e434c7f1aULL,
+			0x1f4c60a13c45216cULL, 0x1f73037e83c18e57ULL,
+			0x1f8e8c007dd332bbULL, 0x1fb1efdfc2579d80ULL,
+			0x1fcf2860bd5ec3f6ULL, 0x1ff04bbf02da6ccdULL,
+		},
+		.U = {
+			0x0000000000000000ULL, 0x001a052dac7a33c5ULL,
+			0x000b6984e770c8b1ULL, 0x00116ca94b0afb74ULL,
+			0x0016d309cee19162ULL, 0x000cd624629ba2a7ULL,
+			0x001dba8d299159d3ULL, 0x0007bfa085eb6a16ULL,
+			0x0012c5cc22478dffULL, 0x0008c0e18e3dbe3aULL,
+			0x0019ac48c537454eULL, 0x0003a965694d768bULL,
+			0x000416c5eca61c9dULL, 0x001e13e840dc2f58ULL,
+			0x000f7f410bd6d42cULL, 0x00157a6ca7ace7e9ULL,
+			0x001ae847fb0bb4c5ULL, 0x0000ed6a57718700ULL,
+			0x001181c31c7b7c74ULL, 0x000b84eeb0014fb1ULL,
+			0x000c3b4e35ea25a7ULL, 0x00163e6399901662ULL,
+			0x000752cad29aed16ULL, 0x001d57e77ee0ded3ULL,
+			0x00082d8bd94c393aULL, 0x001228a675360affULL,
+			0x0003440f3e3cf18bULL, 0x001941229246c24eULL,
+			0x001efe8217ada858ULL, 0x0004fbafbbd79b9dULL,
+			0x00159706f0dd60e9ULL, 0x000f922b5ca7532cULL,
+			0x000ab3504993c6b1ULL, 0x0010b67de5e9f574ULL,
+			0x0001dad4aee30e00ULL, 0x001bdff902993dc5ULL,
+			0x001c6059877257d3ULL, 0x000665742b086416ULL,
+			0x001709dd60029f62ULL, 0x000d0cf0cc78aca7ULL,
+			0x0018769c6bd44b4eULL, 0x000273b1c7ae788bULL,
+			0x00131f188ca483ffULL, 0x00091a3520deb03aULL,
+			0x000ea595a535da2cULL, 0x0014a0b8094fe9e9ULL,
+			0x0005cc114245129dULL, 0x001fc93cee3f2158ULL,
+			0x00105b17b2987274ULL, 0x000a5e3a1ee241b1ULL,
+			0x001b329355e8bac5ULL, 0x000137bef9928900ULL,
+			0x0006881e7c79e316ULL, 0x001c8d33d003d0d3ULL,
+			0x000de19a9b092ba7ULL, 0x0017e4b737731862ULL,
+			0x00029edb90dfff8bULL, 0x00189bf63ca5cc4eULL,
+			0x0009f75f77af373aULL, 0x0013f272dbd504ffULL,
+			0x00144dd25e3e6ee9ULL, 0x000e48fff2445d2cULL,
+			0x001f2456b94ea658ULL, 0x0005217b1534959dULL,
+			0x001566a093278d62ULL, 0x000f638d3f5dbea7ULL,
+			0x001e0f24745745d3ULL, 0x00040a09d82d7616ULL,
+			0x0003b5a95dc61c00ULL, 0x0019b084f1bc2fc5ULL,
+			0x0008dc2dbab6d4b1ULL, 0x0012d90016cce774ULL,
+			0x0007a36cb160009dULL, 0x001da6411d1a3358ULL,
+			0x000ccae85610c82cULL, 0x0016cfc5fa6afbe9ULL,
+			0x001170657f8191ffULL, 0x000b7548d3fba23aULL,
+			0x001a19e198f1594eULL, 0x00001ccc348b6a8bULL,
+			0x000f8ee7682c39a7ULL, 0x00158bcac4560a62ULL,
+			0x0004e7638f5cf116ULL, 0x001ee24e2326c2d3ULL,
+			0x00195deea6cda8c5ULL, 0x000358c30ab79b00ULL,
+			0x0012346a41bd6074ULL, 0x00083147edc753b1ULL,
+			0x001d4b2b4a6bb458ULL, 0x00074e06e611879dULL,
+			0x001622afad1b7ce9ULL, 0x000c278201614f2cULL,
+			0x000b9822848a253aULL, 0x00119d0f28f016ffULL,
+			0x0000f1a663faed8bULL, 0x001af48bcf80de4eULL,
+			0x001fd5f0dab44bd3ULL, 0x0005d0dd76ce7816ULL,
+			0x0014bc743dc48362ULL, 0x000eb95991beb0a7ULL,
+			0x000906f91455dab1ULL, 0x001303d4b82fe974ULL,
+			0x00026f7df3251200ULL, 0x00186a505f5f21c5ULL,
+			0x000d103cf8f3c62cULL, 0x001715115489f5e9ULL,
+			0x000679b81f830e9dULL, 0x001c7c95b3f93d58ULL,
+			0x001bc3353612574eULL, 0x0001c6189a68648bULL,
+			0x0010aab1d1629fffULL, 0x000aaf9c7d18ac3aULL,
+			0x00053db721bfff16ULL, 0x001f389a8dc5ccd3ULL,
+			0x000e5433c6cf37a7ULL, 0x0014511e6ab50462ULL,
+			0x0013eebeef5e6e74ULL, 0x0009eb9343245db1ULL,
+			0x0018873a082ea6c5ULL, 0x00028217a4549500ULL,
+			0x0017f87b03f872e9ULL, 0x000dfd56af82412cULL,
+			0x001c91ffe488ba58ULL, 0x000694d248f2899dULL,
+			0x00012b72cd19e38bULL, 0x001b2e5f6163d04eULL,
+			0x000a42f62a692b3aULL, 0x001047db861318ffULL,
+			0x0015ae9e99cbb5ffULL, 0x000fabb335b1863aULL,
+			0x001ec71a7ebb7d4eULL, 0x0004c237d2c14e8bULL,
+			0x00037d97572a249dULL, 0x001978bafb501758ULL,
+			0x00081413b05aec2cULL, 0x0012113e1c20dfe9ULL,
+			0x00076b52bb8c3800ULL, 0x001d6e7f17f60bc5ULL,
+			0x000c02d65cfcf0b1ULL, 0x001607fbf086c374ULL,
+			0x0011b85b756da962ULL, 0x000bbd76d9179aa7ULL,
+			0x001ad1df921d61d3ULL, 0x0000d4f23e675216ULL,
+			0x000f46d962c0013aULL, 0x001543f4ceba32ffULL,
+			0x00042f5d85b0c98bULL, 0x001e2a7029cafa4eULL,
+			0x001995d0ac219058ULL, 0x000390fd005ba39dULL,
+			0x0012fc544b5158e9ULL, 0x0008f979e72b6b2cULL,
+			0x001d831540878cc5ULL, 0x00078638ecfdbf00ULL,
+			0x0016ea91a7f74474ULL, 0x000cefbc0b8d77b1ULL,
+			0x000b501c8e661da7ULL, 0x00115531221c2e62ULL,
+			0x000039986916d516ULL, 0x001a3cb5c56ce6d3ULL,
+			0x001f1dced058734eULL, 0x000518e37c22408bULL,
+			0x0014744a3728bbffULL, 0x000e71679b52883aULL,
+			0x0009cec71eb9e22cULL, 0x0013cbeab2c3d1e9ULL,
+			0x0002a743f9c92a9dULL, 0x0018a26e55b31958ULL,
+			0x000dd802f21ffeb1ULL, 0x0017dd2f5e65cd74ULL,
+			0x0006b186156f3600ULL, 0x001cb4abb91505c5ULL,
+			0x001b0b0b3cfe6fd3ULL, 0x00010e2690845c16ULL,
+			0x0010628fdb8ea762ULL, 0x000a67a277f494a7ULL,
+			0x0005f5892b53c78bULL, 0x001ff0a48729f44eULL,
+			0x000e9c0dcc230f3aULL, 0x0014992060593cffULL,
+			0x00132680e5b256e9ULL, 0x000923ad49c8652cULL,
+			0x00184f0402c29e58ULL, 0x00024a29aeb8ad9dULL,
+			0x0017304509144a74ULL, 0x000d3568a56e79b1ULL,
+			0x001c59c1ee6482c5ULL, 0x00065cec421eb100ULL,
+			0x0001e34cc7f5db16ULL, 0x001be6616b8fe8d3ULL,
+			0x000a8ac8208513a7ULL, 0x00108fe58cff2062ULL,
+			0x0000c83e0aec389dULL, 0x001acd13a6960b58ULL,
+			0x000ba1baed9cf02cULL, 0x0011a49741e6c3e9ULL,
+			0x00161b37c40da9ffULL, 0x000c1e1a68779a3aULL,
+			0x001d72b3237d614eULL, 0x0007779e8f07528bULL,
+			0x00120df228abb562ULL, 0x000808df84d186a7ULL,
+			0x00196476cfdb7dd3ULL, 0x0003615b63a14e16ULL,
+			0x0004defbe64a2400ULL, 0x001edbd64a3017c5ULL,
+			0x000fb77f013aecb1ULL, 0x0015b252ad40df74ULL,
+			0x001a2079f1e78c58ULL, 0x000025545d9dbf9dULL,
+			0x001149fd169744e9ULL, 0x000b4cd0baed772cULL,
+			0x000cf3703f061d3aULL, 0x0016f65d937c2effULL,
+			0x00079af4d876d58bULL, 0x001d9fd9740ce64eULL,
+			0x0008e5b5d3a001a7ULL, 0x0012e0987fda3262ULL,
+			0x00038c3134d0c916ULL, 0x0019891c98aafad3ULL,
+			0x001e36bc1d4190c5ULL, 0x00043391b13ba300ULL,
+			0x00155f38fa315874ULL, 0x000f5a15564b6bb1ULL,
+			0x000a7b6e437ffe2cULL, 0x00107e43ef05cde9ULL,
+			0x000112eaa40f369dULL, 0x001b17c708750558ULL,
+			0x001ca8678d9e6f4eULL, 0x0006ad4a21e45c8bULL,
+			0x0017c1e36aeea7ffULL, 0x000dc4cec694943aULL,
+			0x0018bea2613873d3ULL, 0x0002bb8fcd424016ULL,
+			0x0013d7268648bb62ULL, 0x0009d20b2a3288a7ULL,
+			0x000e6dabafd9e2b1ULL, 0x0014688603a3d174ULL,
+			0x0005042f48a92a00ULL, 0x001f0102e4d319c5ULL,
+			0x00109329b8744ae9ULL, 0x000a9604140e792cULL,
+			0x001bfaad5f048258ULL, 0x0001ff80f37eb19dULL,
+			0x000640207695db8bULL, 0x001c450ddaefe84eULL,
+			0x000d29a491e5133aULL, 0x00172c893d9f20ffULL,
+			0x000256e59a33c716ULL, 0x001853c83649f4d3ULL,
+			0x00093f617d430fa7ULL, 0x00133a4cd1393c62ULL,
+			0x001485ec54d25674ULL, 0x000e80c1f8a865b1ULL,
+			0x001fec68b3a29ec5ULL, 0x0005e9451fd8ad00ULL,
+		},
+	},
+};
@@ -0,0 +1,54 @@
+#!/usr/bin/python
+
+# Compare two runs of examples/bench, by median ns/byte:
+#
+#	test/bench_compare.py baseline.json new.json [percent]
+#
+# Prints every case both have, and exits 1 if any got slower by more
+# than percent (default 5), or did different work (its check value
+# changed) -- which for a chunker means it cut different blocks.
+
+from __future__ import print_function
+
+import json
+import sys
+
+if len(sys.argv) not in (3, 4):
+	sys.exit('usage: %s baseline.json new.json [percent]' % sys.argv[0])
+
+base = json.load(open(sys.argv[1]))
+new = json.load(open(sys.argv[2]))
+threshold = float(sys.argv[3]) if len(sys.argv) == 4 else 5.0
+
+if base['simd'] != new['simd'] or base['cpu'] != new['cpu']:
+	print('warning: baseline ran with simd %s on cpu %d, this with '
+	      'simd %s on cpu %d' % (base['simd'], base['cpu'],
+				    new['simd'], new['cpu']))
+
+failed = []
+print('%-44s %10s %10s %8s' % ('case', 'base ns/B', 'new ns/B', 'change'))
+for name in sorted(new['results']):
+	if name not in base['results']:
+		continue
+	b = base['results'][name]
+	n = new['results'][name]
+	was = b['p50']['ns_per_byte']
+	now = n['p50']['ns_per_byte']
+	change = (now - was) / was * 100 if was else 0.0
+	note = ''
+	if b['check'] != n['check']:
+		note = '  different output'
+		failed.append(name)
+	elif change > threshold:
+		note = '  slower'
+		failed.append(name)
+	print('%-44s %10.4f %10.4f %+7.1f%%%s' % (name, was, now, change, note))
+
+missing = sorted(set(base['results']) - set(new['results']))
+if missing:
+	print('not run: %s' % ' '.join(missing))
+
+if failed:
+	print('%d of %d cases regressed (threshold %g%%)' %
+	      (len(failed), len(new['results']), threshold))
+	sys.exit(1)
@@ -9,12 +9,7 @@ import rabinpoly as lib
 
 fn = sys.argv[1]
 
-libc = CDLL("libc.so.6")
-
-fopen = libc.fopen
-fread = libc.fread
-feof = libc.feof
-fread.argtypes = [c_void_p, c_size_t, c_size_t, c_void_p]
+FINGERPRINT_PT = 0xbfe6b8a5bf378d83
 
 window_size = 32
 min_block_size = 2**14
@@ -22,27 +17,26 @@ avg_block_size = 2**15
 max_block_size = 2**16
 buf_size = max_block_size*2
 
+# one library call per this many blocks, rather than one per block
+batch_size = 1024
+
 def run():
-    rp = lib.rp_init(
-       window_size, avg_block_size, min_block_size, max_block_size)
+    rp = lib.rp_new(
+       window_size, avg_block_size, min_block_size, max_block_size,
+       buf_size, FINGERPRINT_PT)
     rpc = rp.contents
 
-    buf = create_string_buffer(buf_size)
+    blocks = (lib.rp_boundary * batch_size)()
 
-    fh = fopen(fn, "rb")
+    lib.rp_from_file(rp, fn)
 
     total_size = 0
     while True:
-        if rpc.state & lib.RP_IN:
-            fread_size = fread(buf, 1, buf_size, fh)
-            rc = lib.rp_in(rp, buf, fread_size)
-            assert rc == 1
-        if rpc.state & lib.RP_OUT:
-            rc = lib.rp_out(rp)
-            assert rc == 1
-            total_size += rpc.frag_size
-        if rpc.state & lib.RP_RESET:
-            assert feof(fh)
+        n = lib.rp_find_boundaries(rp, blocks, batch_size)
+        for i in range(n):
+            total_size += blocks[i].length
+        if n < batch_size:
+            assert rpc.error == -1
             break
 
     lib.rp_free(rp)
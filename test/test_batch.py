@@ -0,0 +1,63 @@
+#!/usr/bin/python
+
+from ctypes import *
+
+import rabinpoly as lib
+
+# python's errno module doesn't include EOF
+EOF = -1
+
+FINGERPRINT_PT = 0xbfe6b8a5bf378d83
+
+window_size = 32
+min_block_size = 1024
+avg_block_size = 8192
+max_block_size = 65536
+buf_size = 128*1024
+
+fn = 'test/data/random-42x1M.dat'
+
+rp = lib.rp_new(window_size, avg_block_size, min_block_size,
+		max_block_size, buf_size, FINGERPRINT_PT)
+rpc = rp.contents
+
+lib.rp_from_file(rp, fn)
+ref = []
+while True:
+	rc = lib.rp_block_next(rp)
+	if rc:
+		assert rc == EOF
+		break
+	ref.append((rpc.block_streampos, rpc.block_size, rpc.fingerprint))
+
+def batched(batch_size):
+	blocks = (lib.rp_boundary * batch_size)()
+	out = []
+	while True:
+		n = lib.rp_find_boundaries(rp, blocks, batch_size)
+		for i in range(n):
+			b = blocks[i]
+			out.append((b.offset, b.length, b.fingerprint))
+		if n < batch_size:
+			assert rpc.error == EOF
+			break
+	# once at EOF, we stay there
+	assert lib.rp_find_boundaries(rp, blocks, batch_size) == 0
+	return out
+
+for batch_size in (1, 7, len(ref), 1000):
+	lib.rp_from_file(rp, fn)
+	got = batched(batch_size)
+	print batch_size, len(got)
+	assert got == ref
+
+# same again through the stdio path, where blocks move around in inbuf
+libc = CDLL("libc.so.6")
+libc.fopen.restype = c_void_p
+libc.fclose.argtypes = [c_void_p]
+fh = libc.fopen(fn, "rb")
+lib.rp_from_stream(rp, cast(fh, POINTER(lib.FILE)))
+assert batched(64) == ref
+libc.fclose(fh)
+
+lib.rp_free(rp)
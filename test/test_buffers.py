@@ -0,0 +1,50 @@
+#!/usr/bin/python
+
+from ctypes import *
+
+import rabinpoly as lib
+
+MiB = 1024 * 1024
+
+lib.rp_buffer_get.restype = c_void_p
+lib.rp_buffer_put.argtypes = [c_void_p]
+
+# small and large buffers alike are cache line aligned and writable
+for size in (0, 1, 4096, 128 * 1024, 2 * MiB, 3 * MiB, 8 * MiB):
+	buf = lib.rp_buffer_get(size)
+	assert buf and buf % 64 == 0, size
+	memset(buf, 0xaa, size)
+	lib.rp_buffer_put(buf)
+lib.rp_buffer_put(None)
+
+# large ones are huge page aligned and come back for the same size
+a = lib.rp_buffer_get(8 * MiB)
+b = lib.rp_buffer_get(8 * MiB)
+assert a != b and a % (2 * MiB) == 0 and b % (2 * MiB) == 0
+lib.rp_buffer_put(a)
+assert lib.rp_buffer_get(8 * MiB - 100) == a
+lib.rp_buffer_put(a)
+lib.rp_buffer_put(b)
+
+# a RabinPoly takes one once it reads into it, not before, and
+# recycles it through rp_free()
+rp = lib.rp_new(32, 8192, 1024, 65536, 8 * MiB, 0xbfe6b8a5bf378d83)
+data = (c_ubyte * 100000)()
+lib.rp_from_view(rp, data, len(data))
+while not lib.rp_block_next(rp):
+	pass
+assert not rp.contents.ownbuf
+lib.rp_from_buffer(rp, data, len(data))
+buf = addressof(rp.contents.ownbuf.contents)
+assert buf in (a, b)
+lib.rp_free(rp)
+buf = lib.rp_buffer_get(8 * MiB)
+assert buf in (a, b)
+lib.rp_buffer_put(buf)
+
+# once trimmed, the free ones are gone for good
+lib.rp_buffer_trim()
+c = lib.rp_buffer_get(8 * MiB)
+assert c % (2 * MiB) == 0
+lib.rp_buffer_put(c)
+lib.rp_buffer_trim()
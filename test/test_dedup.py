@@ -0,0 +1,79 @@
+#!/usr/bin/python
+
+from ctypes import *
+
+import rabinpoly as lib
+
+# python's errno module doesn't include EOF
+EOF = -1
+
+FINGERPRINT_PT = 0xbfe6b8a5bf378d83
+
+window_size = 32
+min_block_size = 1024
+avg_block_size = 8192
+max_block_size = 65536
+buf_size = 128*1024
+
+fn = 'test/data/random-42x1M.dat'
+
+data = open(fn, 'rb').read()
+a = data[:300000]
+b = data[300000:700000]
+
+rp = lib.rp_new(window_size, avg_block_size, min_block_size,
+		max_block_size, buf_size, FINGERPRINT_PT)
+rpc = rp.contents
+
+def scan(d, src, file):
+	stats = lib.rp_dedup_stats()
+	lib.rp_from_view(rp, src, len(src))
+	assert lib.rp_dedup_scan(d, rp, file, byref(stats)) == 0
+	return stats
+
+for kind in (lib.RP_DIGEST_XXH3_128, lib.RP_DIGEST_BLAKE3):
+	d = lib.rp_dedup_new(kind, 1 << 20)
+	assert d
+
+	# a alone is (almost certainly) all unique
+	s = scan(d, a, 0)
+	assert s.bytes == len(a) and s.unique_bytes == len(a)
+	assert s.untracked_blocks == 0
+
+	# a + b + a: only b's blocks and those at the seams are new
+	s = scan(d, a + b + a, 1)
+	print kind, s.blocks, s.unique_blocks, s.bytes - s.unique_bytes
+	assert s.bytes == len(a) * 2 + len(b)
+	assert s.unique_bytes < len(b) + 2 * max_block_size
+	assert s.bytes - s.unique_bytes > len(a)
+
+	# nothing new the second time round
+	s = scan(d, a + b + a, 2)
+	assert s.unique_blocks == 0 and s.unique_bytes == 0
+
+	t = lib.rp_dedup_stats()
+	lib.rp_dedup_totals(d, byref(t))
+	assert t.bytes == len(a) * 3 + len(b) * 2 + len(a) * 2
+
+	# the first block of a was first seen in file 0, then once more in
+	# each of the others: the second a follows b mid-block
+	lib.rp_from_view(rp, a, len(a))
+	assert lib.rp_block_next(rp) == 0
+	e = lib.rp_dedup_lookup(d, rpc.block_digest)
+	assert e
+	e = e.contents
+	assert (e.file, e.offset, e.length, e.refs) == \
+		(0, 0, rpc.block_size, 3)
+	assert not lib.rp_dedup_lookup(d, (c_ubyte * 32)())
+	lib.rp_dedup_free(d)
+
+# an index too small for everything still counts everything
+d = lib.rp_dedup_new(lib.RP_DIGEST_XXH3_128, 4 * sizeof(lib.rp_dedup_entry))
+s = scan(d, a + b + a, 0)
+assert s.bytes == len(a) * 2 + len(b)
+assert s.untracked_blocks == s.unique_blocks - 3
+lib.rp_dedup_free(d)
+
+assert not lib.rp_dedup_new(lib.RP_DIGEST_NONE, 1 << 20)
+
+lib.rp_free(rp)
@@ -0,0 +1,91 @@
+#!/usr/bin/python
+
+from ctypes import *
+
+import rabinpoly as lib
+
+# python's errno module doesn't include EOF
+EOF = -1
+EINVAL = 22
+
+FINGERPRINT_PT = 0xbfe6b8a5bf378d83
+
+window_size = 32
+min_block_size = 1024
+avg_block_size = 8192
+max_block_size = 65536
+buf_size = 128*1024
+
+fn = 'test/data/random-42x1M.dat'
+
+def digest(kind, data):
+	out = create_string_buffer(lib.RP_DIGEST_MAX)
+	lib.rp_digest(kind, data, len(data), cast(out, POINTER(c_ubyte)))
+	return out.raw[:lib.rp_digest_size(kind)].encode('hex')
+
+# known answers; BLAKE3 over the usual i % 251 test pattern, which
+# spans one, two, nine and a hundred 1 KiB chunks
+assert digest(lib.RP_DIGEST_XXH3_128, '') == \
+	'99aa06d3014798d86001c324468d497f'
+blake3 = {
+	0: 'af1349b9f5f9a1a6a0404dea36dcc9499bcb25c9adc112b7cc9a93cae41f3262',
+	1: '2d3adedff11b61f14c886e35afa036736dcd87a74d27b5c1510225d0f592e213',
+	1024: '42214739f095a406f3fc83deb889744ac00df831c10daa55189b5d121c855af7',
+	1025: 'd00278ae47eb27b34faecf67b4fe263f82d5412916c1ffd97c8cb7fb814b8444',
+	8193: 'bab6c09cb8ce8cf459261398d2e7aef35700bf488116ceb94a36d0f5f1b7bc3b',
+	102400: 'bc3e3d41a1146b069abffad3c0d44860cf664390afce4d9661f7902e7943e085',
+}
+for n, want in sorted(blake3.items()):
+	data = ''.join(chr(i % 251) for i in range(n))
+	assert digest(lib.RP_DIGEST_BLAKE3, data) == want, n
+
+data = open(fn, 'rb').read()
+rp = lib.rp_new(window_size, avg_block_size, min_block_size,
+		max_block_size, buf_size, FINGERPRINT_PT)
+rpc = rp.contents
+
+assert lib.rp_set_digest(rp, 3) == EINVAL
+
+for kind in (lib.RP_DIGEST_XXH3_128, lib.RP_DIGEST_BLAKE3):
+	size = lib.rp_digest_size(kind)
+	assert lib.rp_set_digest(rp, kind) == 0
+
+	# each block's digest is that of its bytes, whatever the source
+	lib.rp_from_file(rp, fn)
+	ref = []
+	while True:
+		rc = lib.rp_block_next(rp)
+		if rc:
+			assert rc == EOF
+			break
+		d = string_at(rpc.block_digest, size).encode('hex')
+		block = data[rpc.block_streampos:
+			     rpc.block_streampos + rpc.block_size]
+		assert d == digest(kind, block)
+		ref.append((rpc.block_streampos, rpc.block_size, d))
+	print kind, len(ref)
+
+	# the batch call hands out the same, packed
+	blocks = (lib.rp_boundary * 100)()
+	digests = (c_ubyte * (100 * size))()
+	got = []
+	lib.rp_from_view(rp, data, len(data))
+	while True:
+		n = lib.rp_find_boundaries_digest(rp, blocks, digests, 100)
+		for i in range(n):
+			d = string_at(addressof(digests) + i * size, size)
+			got.append((blocks[i].offset, blocks[i].length,
+				    d.encode('hex')))
+		if n < 100:
+			assert rpc.error == EOF
+			break
+	assert got == ref
+
+# and digests can be turned off again
+assert lib.rp_set_digest(rp, lib.RP_DIGEST_NONE) == 0
+lib.rp_from_view(rp, data, len(data))
+assert lib.rp_block_next(rp) == 0
+assert string_at(rpc.block_digest, lib.RP_DIGEST_MAX) == \
+	'\0' * lib.RP_DIGEST_MAX
+
+lib.rp_free(rp)
@@ -0,0 +1,55 @@
+#!/usr/bin/python
+
+from ctypes import *
+
+import rabinpoly as lib
+
+# python's errno module doesn't include EOF
+EOF = -1
+
+FINGERPRINT_PT = 0xbfe6b8a5bf378d83
+
+min_block_size = 1024
+avg_block_size = 8192
+max_block_size = 65536
+
+fn = 'test/data/random-42x1M.dat'
+
+# long enough to be split into lanes
+size = 256*1024
+data = open(fn, 'rb').read()[:size]
+buf = create_string_buffer(data, len(data))
+
+for window_size in (32, 512):
+	rp = lib.rp_new(window_size, avg_block_size, min_block_size,
+			max_block_size, 0, FINGERPRINT_PT)
+	rpc = rp.contents
+
+	# reference: one calc_rabin() per byte
+	lib.rp_from_view(rp, buf, size)
+	ref = []
+	while lib.calc_rabin(rp) != EOF:
+		ref.append(rpc.fingerprint)
+	assert len(ref) == size
+
+	for start in (0, 1, window_size - 1, 1000):
+		out = (c_uint64 * (size - start))()
+		lib.rp_fingerprints(rp, buf, start, size, out)
+		assert list(out) == ref[start:], (window_size, start)
+
+	mask = 0xff
+	want = [(i, fp) for i, fp in enumerate(ref) if not fp & mask]
+	matches = (lib.rp_match * 16)()
+	got = []
+	pos = 0
+	while True:
+		n = lib.rp_fingerprint_matches(rp, buf, pos, size, mask,
+				matches, 16)
+		got += [(m.pos, m.fingerprint) for m in matches[:n]]
+		if n < 16:
+			break
+		pos = got[-1][0] + 1
+	print window_size, len(got)
+	assert got == want
+
+	lib.rp_free(rp)
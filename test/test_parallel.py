@@ -0,0 +1,90 @@
+#!/usr/bin/python
+
+from ctypes import *
+
+import rabinpoly as lib
+
+# python's errno module doesn't include EOF
+EOF = -1
+
+FINGERPRINT_PT = 0xbfe6b8a5bf378d83
+
+window_size = 32
+min_block_size = 1024
+avg_block_size = 8192
+max_block_size = 65536
+buf_size = 128*1024
+
+fn = 'test/data/random-42x1M.dat'
+
+def blocks(rp, find, batch_size):
+	rpc = rp.contents
+	out = (lib.rp_boundary * batch_size)()
+	got = []
+	while True:
+		n = find(rp, out, batch_size)
+		got += [(b.offset, b.length, b.fingerprint) for b in out[:n]]
+		if n < batch_size:
+			assert rpc.error == EOF
+			break
+	return got
+
+for engine in (lib.RP_ENGINE_RABIN, lib.RP_ENGINE_GEAR):
+	rp = lib.rp_new_engine(engine, window_size, avg_block_size,
+			min_block_size, max_block_size, buf_size, FINGERPRINT_PT)
+
+	lib.rp_from_file(rp, fn)
+	ref = blocks(rp, lib.rp_find_boundaries, 1024)
+
+	for nthreads in (1, 3, 0):
+		for batch_size in (1, 10, 100000):
+			lib.rp_from_file(rp, fn)
+			par = lambda rp, out, max: \
+				lib.rp_find_boundaries_parallel(rp, out, max, nthreads)
+			got = blocks(rp, par, batch_size)
+			assert got == ref, (engine, nthreads, batch_size)
+	print engine, len(ref)
+
+	# serial and parallel calls can take turns on one input
+	lib.rp_from_file(rp, fn)
+	out = (lib.rp_boundary * 10)()
+	got = []
+	while True:
+		n = lib.rp_find_boundaries(rp, out, 3)
+		got += [(b.offset, b.length, b.fingerprint) for b in out[:n]]
+		if n < 3:
+			break
+		n = lib.rp_find_boundaries_parallel(rp, out, 10, 2)
+		got += [(b.offset, b.length, b.fingerprint) for b in out[:n]]
+		if n < 10:
+			break
+	assert got == ref
+
+	lib.rp_free(rp)
+
+# a parallel call leaves the window behind for serial ones to carry on
+# from: here a last block shorter than the window, whose fingerprint
+# is rebuilt from it
+data = open(fn, 'rb').read()[:1024 * 1024]
+for engine in (lib.RP_ENGINE_RABIN, lib.RP_ENGINE_GEAR):
+	rp = lib.rp_new_engine(engine, 64, 4096, 1024, 16384, 0,
+			FINGERPRINT_PT)
+	rpc = rp.contents
+	lib.rp_from_view(rp, data, len(data))
+	cut = blocks(rp, lib.rp_find_boundaries, 1024)[-10][0]
+	tail = data[:cut + 30]
+
+	lib.rp_from_view(rp, tail, len(tail))
+	ref = blocks(rp, lib.rp_find_boundaries, 1024)
+	assert ref[-1][:2] == (cut, 30)
+
+	lib.rp_from_view(rp, tail, len(tail))
+	out = (lib.rp_boundary * len(ref))()
+	n = lib.rp_find_boundaries_parallel(rp, out, len(ref) - 1, 2)
+	got = [(b.offset, b.length, b.fingerprint) for b in out[:n]]
+	assert lib.rp_block_next(rp) == 0
+	got.append((rpc.block_streampos, rpc.block_size, rpc.fingerprint))
+	assert lib.rp_block_next(rp) == EOF
+	assert got == ref, engine
+
+	lib.rp_free(rp)
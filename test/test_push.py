@@ -0,0 +1,114 @@
+#!/usr/bin/python
+
+from ctypes import *
+import random
+
+import rabinpoly as lib
+
+# python's errno module doesn't include EOF
+EOF = -1
+EINVAL = 22
+EBUSY = 16
+EAGAIN = 11
+
+FINGERPRINT_PT = 0xbfe6b8a5bf378d83
+
+window_size = 32
+min_block_size = 1024
+avg_block_size = 8192
+max_block_size = 65536
+
+fn = 'test/data/random-42x1M.dat'
+
+data = open(fn, 'rb').read()
+
+def new():
+	# a push stream needs no more buffer than a block
+	return lib.rp_new(window_size, avg_block_size, min_block_size,
+			  max_block_size, max_block_size, FINGERPRINT_PT)
+
+rp = new()
+rpc = rp.contents
+lib.rp_set_digest(rp, lib.RP_DIGEST_XXH3_128)
+size = lib.rp_digest_size(lib.RP_DIGEST_XXH3_128)
+
+def block():
+	return (rpc.block_streampos, rpc.block_size, rpc.fingerprint,
+		string_at(rpc.block_addr, rpc.block_size),
+		string_at(rpc.block_digest, size))
+
+lib.rp_from_view(rp, data, len(data))
+ref = []
+while not lib.rp_block_next(rp):
+	ref.append(block())
+
+def packets(sizes):
+	pos = 0
+	while pos < len(data):
+		n = random.choice(sizes)
+		yield data[pos:pos + n]
+		pos += n
+
+random.seed(42)
+
+# packets of all sizes, from a few bytes to several blocks; each is
+# scribbled over as soon as it's used up, so nothing can still be
+# looking at it
+for sizes in ((1, 7, 100), (1000, 1500, 9000), (65536, 300000)):
+	got = []
+	for p in packets(sizes):
+		buf = create_string_buffer(p, len(p))
+		assert lib.rp_push(rp, buf, len(p)) == 0
+		while True:
+			rc = lib.rp_block_next(rp)
+			if rc:
+				assert rc == EAGAIN
+				break
+			got.append(block())
+		memset(buf, 0x55, len(p))
+	assert lib.rp_push(rp, None, 0) == 0
+	while not lib.rp_block_next(rp):
+		got.append(block())
+	assert rpc.error == EOF
+	assert got == ref
+	# the stream is over until rp_reset()
+	assert lib.rp_push(rp, data, 10) == EOF
+	lib.rp_reset(rp)
+
+# one packet at a time
+assert lib.rp_push(rp, data, 1000) == 0
+assert lib.rp_push(rp, data, 1000) == EBUSY
+lib.rp_reset(rp)
+
+# thousands of streams are many RabinPolys; here two of them, pulled
+# in batches, interleaved
+rps = [rp, new()]
+out = (lib.rp_boundary * 10)()
+got = [[], []]
+for p in packets((4000, 20000)):
+	for i, r in enumerate(rps):
+		assert lib.rp_push(r, p, len(p)) == 0
+		while True:
+			n = lib.rp_pull(r, out, 10)
+			got[i] += [(out[j].offset, out[j].length,
+				    out[j].fingerprint) for j in range(n)]
+			if n < 10:
+				assert r.contents.error == EAGAIN
+				break
+for i, r in enumerate(rps):
+	lib.rp_push(r, None, 0)
+	n = lib.rp_pull(r, out, 10)
+	got[i] += [(out[j].offset, out[j].length, out[j].fingerprint)
+		   for j in range(n)]
+	assert r.contents.error == EOF
+	assert got[i] == [b[:3] for b in ref]
+lib.rp_free(rps[1])
+
+# blocks that span packets need a buffer of max_block_size
+small = lib.rp_new(window_size, avg_block_size, min_block_size,
+		   max_block_size, max_block_size - 1, FINGERPRINT_PT)
+assert lib.rp_push(small, data, 1000) == EINVAL
+lib.rp_free(small)
+
+print len(ref)
+lib.rp_free(rp)
@@ -0,0 +1,64 @@
+#!/usr/bin/python
+
+from ctypes import *
+
+import rabinpoly as lib
+
+# python's errno module doesn't include EOF
+EOF = -1
+
+FINGERPRINT_PT = 0xbfe6b8a5bf378d83
+
+window_size = 32
+min_block_size = 1024
+avg_block_size = 8192
+max_block_size = 65536
+buf_size = 128*1024
+
+fn = 'test/data/random-42x1M.dat'
+
+def blocks(rp):
+	rpc = rp.contents
+	out = []
+	while True:
+		rc = lib.rp_block_next(rp)
+		if rc:
+			assert rc == EOF
+			break
+		out.append((rpc.block_streampos, rpc.block_size, rpc.fingerprint))
+	return out
+
+rp = lib.rp_new(window_size, avg_block_size, min_block_size,
+		max_block_size, buf_size, FINGERPRINT_PT)
+lib.rp_from_file(rp, fn)
+ref = blocks(rp)
+
+# a reset RabinPoly is as good as a new one, partway through or not
+for stop in (0, 10, len(ref)):
+	lib.rp_reset(rp)
+	assert rp.contents.block_streampos == 0 and rp.contents.error == 0
+	lib.rp_from_file(rp, fn)
+	for i in range(stop):
+		lib.rp_block_next(rp)
+	lib.rp_reset(rp)
+	lib.rp_from_file(rp, fn)
+	assert blocks(rp) == ref
+
+# the same polynomial and window share tables; a different window can't
+addr = lambda rp: cast(rp.contents.T, c_void_p).value
+rp2 = lib.rp_new(window_size, avg_block_size, min_block_size,
+		max_block_size, 0, FINGERPRINT_PT)
+rp3 = lib.rp_new(window_size * 2, avg_block_size, min_block_size,
+		max_block_size, 0, FINGERPRINT_PT)
+assert addr(rp2) == addr(rp)
+assert addr(rp3) != addr(rp)
+
+# and freeing one doesn't pull them out from under the other
+lib.rp_free(rp)
+data = open(fn, 'rb').read()
+lib.rp_from_view(rp2, data, len(data))
+assert blocks(rp2) == ref
+print len(ref)
+
+lib.rp_free(rp2)
+lib.rp_free(rp3)
@@ -0,0 +1,123 @@
+#!/usr/bin/python
+
+from ctypes import *
+import random
+
+import rabinpoly as lib
+
+# python's errno module doesn't include EOF
+EOF = -1
+
+FINGERPRINT_PT = 0xbfe6b8a5bf378d83
+
+fn = 'test/data/random-42x1M.dat'
+
+READ = CFUNCTYPE(c_size_t, c_void_p, POINTER(c_ubyte), c_size_t,
+		POINTER(c_int))
+BORROW = CFUNCTYPE(c_void_p, c_void_p, POINTER(c_size_t), POINTER(c_int))
+CLOSE = CFUNCTYPE(None, c_void_p)
+
+# laid out like struct rp_source
+class Source(Structure):
+	_fields_ = [('read', READ), ('borrow', BORROW), ('close', CLOSE)]
+
+# random bytes with a run of zeros in the middle, where blocks are as
+# short as they get
+raw = open(fn, 'rb').read()
+data = raw[:150000] + '\0' * 40000 + raw[150000:250000]
+
+def full_scan(rp, data):
+	"""the blocks hashing every byte gives: fingerprints from
+	rp_fingerprints(), which skips nothing, cut by the rules"""
+	rpc = rp.contents
+	fps = (c_uint64 * len(data))()
+	lib.rp_fingerprints(rp, data, 0, len(data), fps)
+	out = []
+	start = 0
+	for i in range(len(data)):
+		size = i + 1 - start
+		if rpc.engine == lib.RP_ENGINE_GEAR:
+			mask = rpc.gear_mask_s if size < rpc.avg_block_size \
+				else rpc.gear_mask_l
+		else:
+			mask = rpc.fingerprint_mask
+		if size == rpc.max_block_size or \
+		   (size >= rpc.min_block_size and fps[i] & mask == 0):
+			out.append((start, size, fps[i]))
+			start = i + 1
+	if start < len(data):
+		out.append((start, len(data) - start, fps[len(data) - 1]))
+	return out
+
+def blocks(rp):
+	rpc = rp.contents
+	out = []
+	while True:
+		rc = lib.rp_block_next(rp)
+		if rc:
+			assert rc == EOF
+			break
+		out.append((rpc.block_streampos, rpc.block_size,
+			    rpc.fingerprint))
+	return out
+
+# rp hangs on to a source until the next one; so must we
+sources = []
+def from_source(rp, data):
+	pos = [0]
+	def read(ctx, dst, size, error):
+		n = min(size, random.randrange(1, 5000), len(data) - pos[0])
+		if not n:
+			error[0] = EOF
+			return 0
+		memmove(dst, data[pos[0]:pos[0] + n], n)
+		pos[0] += n
+		return n
+	src = Source(READ(read), BORROW(), CLOSE())
+	sources.append((src, read))
+	lib.rp_from_source(rp, cast(pointer(src), POINTER(lib.rp_source)),
+			None)
+
+random.seed(42)
+
+configs = [
+	# engine, window, min, avg, max
+	(lib.RP_ENGINE_RABIN, 32, 1024, 8192, 65536),
+	(lib.RP_ENGINE_RABIN, 32, 64, 256, 1024),	# skips 32 bytes
+	(lib.RP_ENGINE_RABIN, 48, 90, 512, 4096),	# doesn't skip
+	(lib.RP_ENGINE_RABIN, 512, 2048, 8192, 32768),
+	(lib.RP_ENGINE_GEAR, 0, 2048, 8192, 65536),
+	(lib.RP_ENGINE_GEAR, 0, 256, 1024, 8192),
+]
+
+for engine, window_size, min_size, avg_size, max_size in configs:
+	# a buffer only just big enough for a block, so that blocks are
+	# moved to its front all the time
+	rp = lib.rp_new_engine(engine, window_size, avg_size, min_size,
+			       max_size, max_size + 1, FINGERPRINT_PT)
+	rpc = rp.contents
+	ref = full_scan(rp, data)
+
+	lib.rp_from_view(rp, data, len(data))
+	assert blocks(rp) == ref
+	from_source(rp, data)
+	assert blocks(rp) == ref
+
+	# inputs ending at every stage of a block: in what it skips, in
+	# the window it warms up, around min_block_size, and a short
+	# block (here after a run of them in the zeros)
+	skip = min_size - rpc.window_size
+	last = ref[len(ref) // 2][0]
+	ends = [1, 5, skip - 1, skip, skip + 1, min_size - 1, min_size,
+		min_size + 1]
+	for end in [last + e for e in ends if e > 0] + [160000, 160007]:
+		ref_end = full_scan(rp, data[:end])
+		lib.rp_from_view(rp, data, end)
+		assert blocks(rp) == ref_end, (window_size, min_size, end)
+		from_source(rp, data[:end])
+		assert blocks(rp) == ref_end, (window_size, min_size, end)
+
+	s = lib.rp_stats()
+	lib.rp_get_stats(rp, byref(s))
+	print engine, rpc.window_size, min_size, len(ref), s.bytes_skipped
+	lib.rp_free(rp)
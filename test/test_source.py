@@ -0,0 +1,113 @@
+#!/usr/bin/python
+
+from ctypes import *
+import random
+
+import rabinpoly as lib
+
+# python's errno module doesn't include EOF
+EOF = -1
+
+FINGERPRINT_PT = 0xbfe6b8a5bf378d83
+
+window_size = 32
+min_block_size = 1024
+avg_block_size = 8192
+max_block_size = 65536
+buf_size = 128*1024
+
+fn = 'test/data/random-42x1M.dat'
+
+READ = CFUNCTYPE(c_size_t, c_void_p, POINTER(c_ubyte), c_size_t,
+		POINTER(c_int))
+BORROW = CFUNCTYPE(c_void_p, c_void_p, POINTER(c_size_t), POINTER(c_int))
+CLOSE = CFUNCTYPE(None, c_void_p)
+
+# laid out like struct rp_source
+class Source(Structure):
+	_fields_ = [('read', READ), ('borrow', BORROW), ('close', CLOSE)]
+
+def blocks(rp):
+	rpc = rp.contents
+	out = []
+	while True:
+		rc = lib.rp_block_next(rp)
+		if rc:
+			assert rc == EOF
+			break
+		block = string_at(rpc.block_addr, rpc.block_size)
+		out.append((rpc.block_streampos, rpc.block_size, rpc.fingerprint,
+			block))
+	return out
+
+data = open(fn, 'rb').read()
+rp = lib.rp_new(window_size, avg_block_size, min_block_size,
+		max_block_size, buf_size, FINGERPRINT_PT)
+lib.rp_from_view(rp, data, len(data))
+ref = blocks(rp)
+
+# rp hangs on to a source until the next one; so must we
+sources = []
+def from_source(src):
+	sources.append(src)
+	lib.rp_from_source(rp, cast(pointer(src), POINTER(lib.rp_source)),
+			None)
+
+# a read() source, handing out odd amounts at a time
+pos = [0]
+def read(ctx, dst, size, error):
+	n = min(size, random.randrange(1, 100000), len(data) - pos[0])
+	if not n:
+		error[0] = EOF
+		return 0
+	memmove(dst, data[pos[0]:pos[0] + n], n)
+	pos[0] += n
+	return n
+
+closed = [0]
+def close(ctx):
+	closed[0] += 1
+
+random.seed(42)
+src = Source(READ(read), BORROW(), CLOSE(close))
+from_source(src)
+assert blocks(rp) == ref
+
+# borrowed spans of all sizes, from a fraction of a block to several
+# blocks; blocks still come out the same whether or not they straddle
+# spans
+spans = []
+for span_max in (100, 5000, 70000, 300000):
+	cuts = [0]
+	while cuts[-1] < len(data):
+		cuts.append(min(len(data), cuts[-1] + random.randrange(1, span_max + 1)))
+	held = []
+	def borrow(ctx, size, error, cuts=cuts, held=held, i=[0]):
+		if i[0] + 1 >= len(cuts):
+			error[0] = EOF
+			return None
+		start, end = cuts[i[0]], cuts[i[0] + 1]
+		i[0] += 1
+		# only the current span needs to stay valid
+		held[:] = [create_string_buffer(data[start:end], end - start)]
+		size[0] = end - start
+		return addressof(held[0])
+	src = Source(READ(), BORROW(borrow), CLOSE(close))
+	from_source(src)
+	assert blocks(rp) == ref, span_max
+	spans.append(span_max)
+
+# each source was closed when the next one took over
+assert closed[0] == len(spans)
+
+# borrowing needs room for a whole straddling block
+small = lib.rp_new(window_size, avg_block_size, min_block_size,
+		max_block_size, max_block_size - 1, FINGERPRINT_PT)
+lib.rp_from_source(small, cast(pointer(src), POINTER(lib.rp_source)), None)
+assert lib.rp_block_next(small) != 0
+lib.rp_free(small)
+assert closed[0] == len(spans) + 1
+
+lib.rp_free(rp)
+assert closed[0] == len(spans) + 2
+print len(ref)
@@ -0,0 +1,111 @@
+#!/usr/bin/python
+
+from ctypes import *
+
+import rabinpoly as lib
+
+# python's errno module doesn't include EOF
+EOF = -1
+
+FINGERPRINT_PT = 0xbfe6b8a5bf378d83
+
+window_size = 32
+min_block_size = 1024
+avg_block_size = 8192
+max_block_size = 16384
+buf_size = 128*1024
+
+fn = 'test/data/random-42x1M.dat'
+
+data = open(fn, 'rb').read()
+rp = lib.rp_new(window_size, avg_block_size, min_block_size,
+		max_block_size, buf_size, FINGERPRINT_PT)
+rpc = rp.contents
+
+def stats():
+	s = lib.rp_stats()
+	lib.rp_get_stats(rp, byref(s))
+	return s
+
+def bucket(v):
+	return min(v.bit_length() - 1, lib.RP_STATS_BUCKETS - 1)
+
+def blocks():
+	sizes = []
+	while True:
+		rc = lib.rp_block_next(rp)
+		if rc:
+			assert rc == EOF
+			break
+		sizes.append(rpc.block_size)
+	return sizes
+
+def check(s, sizes):
+	assert s.blocks == len(sizes)
+	assert s.cuts_content + s.cuts_max + s.cuts_end == s.blocks
+	assert s.cuts_max == sizes.count(max_block_size)
+	assert s.cuts_end == 1
+	assert s.bytes_scanned + s.bytes_skipped == len(data)
+	hist = [0] * lib.RP_STATS_BUCKETS
+	for size in sizes:
+		hist[bucket(size)] += 1
+	assert list(s.block_sizes) == hist
+
+# in place: nothing to read
+lib.rp_from_view(rp, data, len(data))
+sizes = blocks()
+s = stats()
+check(s, sizes)
+assert s.cuts_max > 0 and s.bytes_skipped > 0
+assert s.refills == 0 and s.bytes_moved == 0
+print len(sizes), s.cuts_content, s.cuts_max
+
+# through stdio: reads, and partial blocks moved to the front
+lib.rp_clear_stats(rp)
+libc = CDLL("libc.so.6")
+libc.fopen.restype = c_void_p
+libc.fclose.argtypes = [c_void_p]
+fh = libc.fopen(fn, "rb")
+lib.rp_from_stream(rp, cast(fh, POINTER(lib.FILE)))
+assert blocks() == sizes
+s = stats()
+check(s, sizes)
+assert s.bytes_read == len(data) and s.bytes_moved > 0
+assert s.refills > len(data) / buf_size
+assert sum(s.read_times) == s.refills
+assert s.read_ns >= s.read_ns_max > 0
+libc.fclose(fh)
+
+# the parallel scan counts the same blocks
+lib.rp_clear_stats(rp)
+lib.rp_from_view(rp, data, len(data))
+out = (lib.rp_boundary * len(sizes))()
+assert lib.rp_find_boundaries_parallel(rp, out, len(sizes), 4) == len(sizes)
+s = stats()
+assert s.blocks == len(sizes) and s.cuts_max == sizes.count(max_block_size)
+assert s.bytes_scanned == len(data)
+
+# and a block that ends on a candidate at max_block_size is a max cut
+# either way: on zeros every position is one
+zeros = '\0' * 100000
+rp2 = lib.rp_new(window_size, 4096, 4096, 4096, buf_size, FINGERPRINT_PT)
+for find in (lib.rp_find_boundaries,
+	     lambda rp, out, max: lib.rp_find_boundaries_parallel(rp, out,
+								 max, 4)):
+	lib.rp_clear_stats(rp2)
+	lib.rp_from_view(rp2, zeros, len(zeros))
+	assert find(rp2, out, len(sizes)) == len(zeros) // 4096 + 1
+	s = lib.rp_stats()
+	lib.rp_get_stats(rp2, byref(s))
+	assert s.cuts_content == 0 and s.cuts_max == len(zeros) // 4096
+	assert s.cuts_end == 1
+lib.rp_free(rp2)
+
+# counters add up across inputs until cleared
+lib.rp_from_view(rp, data, len(data))
+blocks()
+assert stats().blocks == 2 * len(sizes)
+lib.rp_clear_stats(rp)
+assert stats().blocks == 0
+
+lib.rp_free(rp)
@@ -0,0 +1,42 @@
+#!/usr/bin/python
+
+# The lookup tables, whether built in or computed, against the
+# definitions in the slowest possible way.
+
+import rabinpoly as lib
+
+MASK = (1 << 64) - 1
+
+def deg(p):
+	return p.bit_length() - 1
+
+def polymod(n, d):
+	while n and deg(n) >= deg(d):
+		n ^= d << (deg(n) - deg(d))
+	return n
+
+def polymmult(x, y, d):
+	r = 0
+	while x:
+		if x & 1:
+			r ^= y
+		x >>= 1
+		y <<= 1
+	return polymod(r, d)
+
+for poly, window_size in ((0xbfe6b8a5bf378d83, 32),
+			  (0x3f63dfbf84af3b, 512),
+			  (0x3f63dfbf84af3b, 48),
+			  (0xfedcba9876543211, 64),
+			  (0x11d, 7)):
+	rp = lib.rp_new(window_size, 8192, 1024, 65536, 0, poly)
+	rpc = rp.contents
+	xshift = deg(poly)
+	t1 = polymod(1 << xshift, poly)
+	# U[m] takes byte m back out of the window: m * x^(8*(window_size-1))
+	u1 = polymod(1 << (8 * (window_size - 1)), poly)
+	for i in range(256):
+		assert rpc.T[i] == (polymmult(i, t1, poly) | (i << xshift)) & MASK
+		assert rpc.U[i] == polymmult(i, u1, poly)
+	lib.rp_free(rp)
+	print hex(poly), window_size
@@ -0,0 +1,64 @@
+#!/usr/bin/python
+
+from ctypes import *
+
+import rabinpoly as lib
+
+# python's errno module doesn't include EOF
+EOF = -1
+
+FINGERPRINT_PT = 0xbfe6b8a5bf378d83
+
+window_size = 32
+min_block_size = 1024
+avg_block_size = 8192
+max_block_size = 65536
+buf_size = 128*1024
+
+fn = 'test/data/random-42x1M.dat'
+
+def blocks(rp):
+	rpc = rp.contents
+	out = []
+	while True:
+		rc = lib.rp_block_next(rp)
+		if rc:
+			assert rc == EOF
+			break
+		out.append((rpc.block_streampos, rpc.block_size, rpc.fingerprint,
+			cast(rpc.block_addr, c_void_p).value))
+	return out
+
+# reference: the same data read through the internal buffer
+rp = lib.rp_new(window_size, avg_block_size, min_block_size,
+		max_block_size, buf_size, FINGERPRINT_PT)
+lib.rp_from_file(rp, fn)
+ref = blocks(rp)
+lib.rp_free(rp)
+
+data = open(fn, 'rb').read()
+buf = create_string_buffer(data, len(data))
+base = addressof(buf)
+
+# a view may be much larger than the internal buffer, which isn't
+# needed at all
+rp = lib.rp_new(window_size, avg_block_size, min_block_size,
+		max_block_size, 0, FINGERPRINT_PT)
+lib.rp_from_view(rp, buf, len(data))
+got = blocks(rp)
+
+assert len(got) == len(ref), (len(got), len(ref))
+for r, g in zip(ref, got):
+	assert r[:3] == g[:3], (r, g)
+	# blocks are handed out in place, not copied
+	assert g[3] == base + g[0], (g, base)
+print len(got)
+
+# the view isn't modified by scanning it
+assert buf.raw[:len(data)] == data
+
+# an empty view is immediately at EOF
+lib.rp_from_view(rp, None, 0)
+assert lib.rp_block_next(rp) == EOF
+
+lib.rp_free(rp)